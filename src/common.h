@@ -49,6 +49,15 @@
 #define GZIP "gzip"
 #define ZSTD "zstd"
 #define ZSTD_EXTENSION ".zst"
+#define ZSTD_DICTIONARY_FILENAME "zstd-dictionary"
+// zstd seekable format: the seek table is a skippable frame at the end of the file
+#define ZSTD_SKIPPABLE_MAGIC 0x184D2A5E
+#define ZSTD_SEEKABLE_MAGIC 0x8F92EAB1
+#define ZSTD_SEEK_TABLE_FOOTER_SIZE 9
+#define BUNDLE_PREFIX "mydumper_bundle_"
+#define BUNDLE_INDEX_HEADER "-- mydumper bundle index\n"
+#define BUNDLE_INDEX_TRAILER "-- mydumper bundle index at "
+#define BUNDLE_INDEX_TRAILER_SIZE (sizeof(BUNDLE_INDEX_TRAILER) - 1 + 20 + 1)
 #define GZIP_EXTENSION ".gz"
 #define EMPTY_STRING ""
 #define CAST "CAST("
@@ -112,6 +121,7 @@ struct M_ROW{
 #define STREAM_BUFFER_SIZE_NO_STREAM 100
 #define DEFAULTS_FILE "/etc/mydumper.cnf"
 struct function_pointer;
+struct masquerade_shard;
 typedef gboolean (*fun_ptr)(GString *,gchar*,gulong*, struct function_pointer*);
 
 struct function_pointer{
@@ -125,11 +135,11 @@ struct function_pointer{
   // Used inside the function
   GList *parse;
   GList *delimiters;
-  GHashTable *memory;
+  struct masquerade_shard *memory;
   gboolean replace_null;
   guint max_length;
   guint null_max_length;
-  GList *unique_list;
+  struct masquerade_shard *unique_set;
   gboolean unique;
 };
 
@@ -70,6 +70,10 @@ guint throttle_value=0;
 
 gchar *server_version_arg=NULL;
 
+gchar *encryption_key_file=NULL;
+
+gchar *datadir=NULL;
+
 GList *optimize_key_engines=NULL;
 
 
@@ -216,6 +220,10 @@ GOptionEntry common_entries[] = {
     {"throttle", 0, G_OPTION_FLAG_OPTIONAL_ARG, G_OPTION_ARG_CALLBACK, &common_arguments_callback,
       "Expects a string like 20:Threads_running=10, where 20 indicates the microseconds waiting, then the variable and max allowed value to start throttling. It will check the SHOW GLOBAL STATUS and if it is higher, it will increase the sleep time between SELECT. "
       "If option is used without parameters it will use Threads_running and the amount of threads", NULL},
+    {"encryption-key-file", 0, 0, G_OPTION_ARG_FILENAME, &encryption_key_file,
+      "File with the AES-256 key, as 32 bytes or 64 hexadecimal characters. mydumper encrypts the schema and data files with it and myloader decrypts them", NULL},
+    {"datadir", 0, 0, G_OPTION_ARG_FILENAME, &datadir,
+      "Data directory of the database server, used by the transportable tablespaces. Default: @@datadir", NULL},
     {NULL, 0, 0, G_OPTION_ARG_NONE, NULL, NULL, NULL}};
 
 GOptionEntry common_filter_entries[] = {
@@ -58,6 +58,8 @@ extern guint throttle_time;
 extern gchar *pmm_resolution;
 extern gchar *pmm_path;
 extern gboolean machine_log_json;
+extern gchar *encryption_key_file;
+extern gchar *datadir;
 
 extern GOptionEntry common_filter_entries[];
 extern GOptionEntry common_connection_entries[];
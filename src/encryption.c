@@ -0,0 +1,263 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Authors:        David Ducos, Percona (david dot ducos at percona dot com)
+*/
+
+#include <mysql.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <pthread.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include "common.h"
+#include "common_options.h"
+#include "encryption.h"
+
+#define ENCRYPTION_KEY_SIZE 32
+#define ENCRYPTION_HEADER_SIZE 16
+#define ENCRYPTION_NONCE_SIZE 12
+#define ENCRYPTION_TAG_SIZE 16
+#define ENCRYPTION_LAST_RECORD 0x80000000
+
+static guchar encryption_key[ENCRYPTION_KEY_SIZE];
+
+struct encryption_job{
+  int in;
+  int out;
+  gchar *filename;
+};
+
+// The key file has the 32 bytes of the key, or 64 hexadecimal characters
+void initialize_encryption(){
+  gchar *content=NULL;
+  gsize length=0;
+  GError *error=NULL;
+  if (!g_file_get_contents(encryption_key_file, &content, &length, &error))
+    m_critical("Not able to read the encryption key file %s: %s", encryption_key_file, error->message);
+  if (length == ENCRYPTION_KEY_SIZE){
+    memcpy(encryption_key, content, ENCRYPTION_KEY_SIZE);
+  }else{
+    g_strstrip(content);
+    guint i;
+    if (strlen(content) != ENCRYPTION_KEY_SIZE * 2)
+      m_critical("The encryption key file %s must have 32 bytes or 64 hexadecimal characters", encryption_key_file);
+    for (i=0; i < ENCRYPTION_KEY_SIZE; i++){
+      gint high=g_ascii_xdigit_value(content[2*i]), low=g_ascii_xdigit_value(content[2*i+1]);
+      if (high < 0 || low < 0)
+        m_critical("The encryption key file %s must have 32 bytes or 64 hexadecimal characters", encryption_key_file);
+      encryption_key[i]=high << 4 | low;
+    }
+  }
+  memset(content, 0, length);
+  g_free(content);
+}
+
+gboolean is_encrypted_filename(const gchar *filename){
+  return g_str_has_suffix(filename, ENCRYPTION_EXTENSION);
+}
+
+static
+gsize read_full(int fd, guchar *buffer, gsize size){
+  gsize done=0;
+  ssize_t r=0;
+  while (done < size){
+    r=read(fd, buffer + done, size - done);
+    if (r == 0)
+      break;
+    if (r < 0){
+      if (errno == EINTR)
+        continue;
+      return G_MAXSIZE;
+    }
+    done+=r;
+  }
+  return done;
+}
+
+static
+gboolean write_full(int fd, const guchar *buffer, gsize size){
+  gsize done=0;
+  ssize_t w=0;
+  while (done < size){
+    w=write(fd, buffer + done, size - done);
+    if (w < 0){
+      if (errno == EINTR)
+        continue;
+      return FALSE;
+    }
+    done+=w;
+  }
+  return TRUE;
+}
+
+static
+void set_le32(guchar *buffer, guint32 value){
+  value=GUINT32_TO_LE(value);
+  memcpy(buffer, &value, sizeof(value));
+}
+
+static
+guint32 get_le32(const guchar *buffer){
+  guint32 value;
+  memcpy(&value, buffer, sizeof(value));
+  return GUINT32_FROM_LE(value);
+}
+
+// Initializes the context for the record and authenticates the header and
+// the length of the record
+static
+gboolean init_record(EVP_CIPHER_CTX *ctx, gboolean encrypt, const guchar *header, guint32 counter, const guchar *length){
+  guchar nonce[ENCRYPTION_NONCE_SIZE];
+  int outl=0;
+  memcpy(nonce, header + sizeof(ENCRYPTION_MAGIC) - 1, ENCRYPTION_NONCE_SIZE - 4);
+  set_le32(nonce + ENCRYPTION_NONCE_SIZE - 4, counter);
+  return EVP_CipherInit_ex(ctx, EVP_aes_256_gcm(), NULL, encryption_key, nonce, encrypt) == 1 &&
+         EVP_CipherUpdate(ctx, NULL, &outl, header, ENCRYPTION_HEADER_SIZE) == 1 &&
+         EVP_CipherUpdate(ctx, NULL, &outl, length, 4) == 1;
+}
+
+static
+gboolean encrypt_record(EVP_CIPHER_CTX *ctx, int out, const guchar *header, guint32 counter, const guchar *plain, guint32 size, gboolean last, guchar *cipher){
+  guchar length[4];
+  int outl=0, finall=0;
+  set_le32(length, size | (last ? ENCRYPTION_LAST_RECORD : 0));
+  if (!init_record(ctx, TRUE, header, counter, length) ||
+      (size > 0 && EVP_EncryptUpdate(ctx, cipher, &outl, plain, size) != 1) ||
+      EVP_EncryptFinal_ex(ctx, cipher + outl, &finall) != 1 ||
+      EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, ENCRYPTION_TAG_SIZE, cipher + size) != 1)
+    return FALSE;
+  return write_full(out, length, 4) && write_full(out, cipher, size + ENCRYPTION_TAG_SIZE);
+}
+
+// Reads the plaintext from job->in until it is closed. A record is known to
+// be the last one when the next read finds the end of the input.
+static
+void *encryption_thread(struct encryption_job *job){
+  EVP_CIPHER_CTX *ctx=EVP_CIPHER_CTX_new();
+  guchar header[ENCRYPTION_HEADER_SIZE];
+  guchar *current=g_new(guchar, ENCRYPTION_RECORD_SIZE);
+  guchar *next=g_new(guchar, ENCRYPTION_RECORD_SIZE);
+  guchar *cipher=g_new(guchar, ENCRYPTION_RECORD_SIZE + ENCRYPTION_TAG_SIZE);
+  guchar *swap=NULL;
+  guint32 counter=0;
+  gboolean ok=TRUE;
+  memcpy(header, ENCRYPTION_MAGIC, sizeof(ENCRYPTION_MAGIC) - 1);
+  if (RAND_bytes(header + sizeof(ENCRYPTION_MAGIC) - 1, ENCRYPTION_HEADER_SIZE - sizeof(ENCRYPTION_MAGIC) + 1) != 1)
+    m_critical("Not able to generate the nonce of %s", job->filename);
+  ok=write_full(job->out, header, ENCRYPTION_HEADER_SIZE);
+  gsize current_size=read_full(job->in, current, ENCRYPTION_RECORD_SIZE), next_size=0;
+  while (ok && current_size != G_MAXSIZE){
+    next_size=current_size == ENCRYPTION_RECORD_SIZE ? read_full(job->in, next, ENCRYPTION_RECORD_SIZE) : 0;
+    if (next_size == G_MAXSIZE)
+      break;
+    ok=encrypt_record(ctx, job->out, header, counter++, current, current_size, next_size == 0, cipher);
+    if (next_size == 0)
+      break;
+    swap=current; current=next; next=swap;
+    current_size=next_size;
+  }
+  if (!ok || current_size == G_MAXSIZE || next_size == G_MAXSIZE)
+    m_critical("Not able to encrypt %s (%d)", job->filename, errno);
+  close(job->in);
+  EVP_CIPHER_CTX_free(ctx);
+  g_free(current);
+  g_free(next);
+  g_free(cipher);
+  g_free(job->filename);
+  g_free(job);
+  return NULL;
+}
+
+// Encrypts into out everything written to in, until in is closed. The caller
+// owns out and must join the thread before closing it.
+GThread *start_encryption(int in, int out, const gchar *filename){
+  struct encryption_job *job=g_new0(struct encryption_job, 1);
+  job->in=in;
+  job->out=out;
+  job->filename=g_strdup(filename);
+  return m_thread_new("encryption", (GThreadFunc)encryption_thread, job, "Encryption thread could not be created");
+}
+
+// The plaintext of a record is written only after its tag is verified, so
+// the reader never receives data that was not authenticated
+static
+void *decryption_thread(struct encryption_job *job){
+  // If the reader stops, writing fails instead of raising SIGPIPE
+  sigset_t sigpipe;
+  sigemptyset(&sigpipe);
+  sigaddset(&sigpipe, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &sigpipe, NULL);
+
+  EVP_CIPHER_CTX *ctx=EVP_CIPHER_CTX_new();
+  guchar header[ENCRYPTION_HEADER_SIZE], length[4], extra;
+  guchar *cipher=g_new(guchar, ENCRYPTION_RECORD_SIZE + ENCRYPTION_TAG_SIZE);
+  guchar *plain=g_new(guchar, ENCRYPTION_RECORD_SIZE);
+  guint32 counter=0, size=0;
+  int outl=0, finall=0;
+  gboolean last=FALSE;
+  if (read_full(job->in, header, ENCRYPTION_HEADER_SIZE) != ENCRYPTION_HEADER_SIZE ||
+      memcmp(header, ENCRYPTION_MAGIC, sizeof(ENCRYPTION_MAGIC) - 1))
+    m_critical("%s is not an encrypted file", job->filename);
+  while (!last){
+    if (read_full(job->in, length, 4) != 4)
+      m_critical("%s is truncated", job->filename);
+    size=get_le32(length) & ~ENCRYPTION_LAST_RECORD;
+    last=(get_le32(length) & ENCRYPTION_LAST_RECORD) != 0;
+    if (size > ENCRYPTION_RECORD_SIZE || read_full(job->in, cipher, size + ENCRYPTION_TAG_SIZE) != size + ENCRYPTION_TAG_SIZE)
+      m_critical("%s is truncated or corrupted", job->filename);
+    if (!init_record(ctx, FALSE, header, counter++, length) ||
+        (size > 0 && EVP_DecryptUpdate(ctx, plain, &outl, cipher, size) != 1) ||
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, ENCRYPTION_TAG_SIZE, cipher + size) != 1 ||
+        EVP_DecryptFinal_ex(ctx, plain + outl, &finall) != 1)
+      m_critical("Not able to decrypt %s: wrong key or modified file", job->filename);
+    if (!write_full(job->out, plain, size))
+      break;
+  }
+  if (last && read_full(job->in, &extra, 1) != 0)
+    m_critical("%s has data after its last record", job->filename);
+  close(job->in);
+  close(job->out);
+  EVP_CIPHER_CTX_free(ctx);
+  g_free(cipher);
+  g_free(plain);
+  g_free(job->filename);
+  g_free(job);
+  return NULL;
+}
+
+// Returns the read end of a pipe with the plaintext of filename
+int start_decryption(const gchar *filename){
+  int p[2];
+  struct encryption_job *job=g_new0(struct encryption_job, 1);
+  job->in=g_open(filename, O_RDONLY, 0);
+  if (job->in < 0)
+    m_critical("Not able to open %s (%d)", filename, errno);
+  if (pipe(p))
+    m_critical("Not able to create pipe to decrypt %s (%d)", filename, errno);
+  // Only the thread and the reader must have the pipe open, or the reader
+  // would never get the end of file
+  fcntl(p[0], F_SETFD, FD_CLOEXEC);
+  fcntl(p[1], F_SETFD, FD_CLOEXEC);
+  fcntl(job->in, F_SETFD, FD_CLOEXEC);
+  job->out=p[1];
+  job->filename=g_strdup(filename);
+  g_thread_unref(m_thread_new("decryption", (GThreadFunc)decryption_thread, job, "Decryption thread could not be created"));
+  return p[0];
+}
@@ -0,0 +1,41 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    Authors:        David Ducos, Percona (david dot ducos at percona dot com)
+*/
+
+#include <glib.h>
+#ifndef _src_encryption_h
+#define _src_encryption_h
+
+/*
+  Encrypted files are AES-256-GCM records:
+
+    header: ENCRYPTION_MAGIC (8 bytes) | random nonce prefix (8 bytes)
+    record: length (4 bytes LE, bit 31 set on the last record) | ciphertext | tag (16 bytes)
+
+  The nonce of the record N is the nonce prefix followed by N (4 bytes LE),
+  and the header and the length are authenticated with each record. A
+  reordered, modified or truncated file fails to decrypt.
+*/
+#define ENCRYPTION_EXTENSION ".enc"
+#define ENCRYPTION_MAGIC "MYDENC01"
+#define ENCRYPTION_RECORD_SIZE 65536
+
+void initialize_encryption();
+gboolean is_encrypted_filename(const gchar *filename);
+GThread *start_encryption(int in, int out, const gchar *filename);
+int start_decryption(const gchar *filename);
+
+#endif
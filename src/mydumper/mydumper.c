@@ -58,6 +58,8 @@ gboolean skip_metadata_sorting = FALSE;
 gboolean shutdown_triggered = FALSE;
 
 extern gboolean split_string_pk;
+extern gboolean string_pk_sampling;
+extern gboolean use_histograms;
 extern gboolean use_single_column;
 extern guint max_time_per_select;
 extern guint64 min_integer_chunk_step_size;
@@ -114,6 +116,8 @@ void print_help(){
   print_int("max-threads-per-table", max_threads_per_table, FALSE);
   print_bool("use-single-column", use_single_column);
   print_bool("split-string-pk", split_string_pk);
+  print_bool("string-pk-sampling", string_pk_sampling);
+  print_bool("use-histograms", use_histograms);
   print_string("rows",g_strdup_printf("%"G_GUINT64_FORMAT":%"G_GUINT64_FORMAT":%"G_GUINT64_FORMAT,min_chunk_step_size, starting_chunk_step_size, max_chunk_step_size));
   print_string("rows-hard",g_strdup_printf("%"G_GUINT64_FORMAT":%"G_GUINT64_FORMAT,min_integer_chunk_step_size, max_integer_chunk_step_size));
   print_int("max-split-of-step-in-integer-chunk", max_split_of_step_in_integer_chunk, FALSE);
@@ -137,6 +141,7 @@ void print_help(){
 
   print_string("format", outputformat2str(output_format));
   print_bool("include-header",include_header);
+  print_bool("server-outfile",server_outfile);
   print_string("fields-terminated-by",fields_terminated_by_ld);
   print_string("fields-enclosed-by",fields_enclosed_by_ld);
   print_string("fields-escaped-by",fields_escaped_by);
@@ -150,6 +155,8 @@ void print_help(){
   print_bool("skip-definer",skip_definer);
   print_string("replace-definer",replace_definer);
   print_int("statement-size",statement_size, FALSE);
+  print_int("max-memory",max_memory, max_memory==0);
+  print_bool("async-write",async_write);
   print_bool("tz-utc",skip_tz);
   print_bool("skip-tz-utc",skip_tz);
   print_string("set-names", set_names_in_conn_by_default || set_names_in_conn_for_sct ? g_strdup_printf("%s,%s",set_names_in_conn_for_sct,set_names_in_conn_by_default):NULL);
@@ -158,6 +165,9 @@ void print_help(){
   print_string("table-engine-for-view-dependency",table_engine_for_view_dependency);
 
   print_int("chunk-filesize",chunk_filesize, chunk_filesize==0);
+  print_int("coalesce-tables",coalesce_tables, coalesce_tables==0);
+  print_int("transportable-tablespace-size",transportable_tablespace_size, transportable_tablespace_size==0);
+  print_string("datadir",datadir);
   print_bool("exit-if-broken-table-found",exit_if_broken_table_found);
   print_bool("build-empty-files",build_empty_files);
   print_bool("no-check-generated-fields",ignore_generated_fields);
@@ -165,6 +175,10 @@ void print_help(){
   print_bool("order-by-primary",order_by_primary_key);
   print_bool("compact",compact);
   print_bool("compress",compress_method!=NULL);
+  print_int("zstd-dictionary",zstd_dictionary_samples, zstd_dictionary_samples==0);
+  print_int("zstd-frame-size",zstd_frame_size, zstd_frame_size==0);
+  print_int("compress-threads",compress_threads, compress_threads==0);
+  print_string("encryption-key-file",encryption_key_file);
   print_bool("use-defer",use_defer);
   print_bool("check-row-count",check_row_count);
 
@@ -272,6 +286,61 @@ int main(int argc, char *argv[]) {
   if ((exec_per_thread_extension!=NULL) && (exec_per_thread == NULL))
     m_critical("--exec-per-thread needs to be set when --exec-per-thread-extension (%s) is used", exec_per_thread_extension);
 
+  if (zstd_dictionary_samples > 0){
+    if (compress_method==NULL || g_ascii_strcasecmp(compress_method,ZSTD)!=0)
+      m_critical("--zstd-dictionary needs --compress=zstd");
+    if (daemon_mode)
+      m_critical("--zstd-dictionary is not compatible with --daemon");
+  }
+
+  if (zstd_frame_size > 0){
+    if (compress_method==NULL || g_ascii_strcasecmp(compress_method,ZSTD)!=0)
+      m_critical("--zstd-frame-size needs --compress=zstd");
+    if (zstd_dictionary_samples > 0)
+      m_critical("--zstd-frame-size is not compatible with --zstd-dictionary");
+    if (output_format!=SQL_INSERT)
+      m_critical("--zstd-frame-size is only supported with --format=INSERT");
+    // The seek table stores the sizes of the frames in 32 bits
+    if (zstd_frame_size > 1024)
+      m_critical("--zstd-frame-size must be at most 1024");
+  }
+
+  if (compress_threads > 0 && (compress_method==NULL || g_ascii_strcasecmp(compress_method,ZSTD)!=0))
+    m_critical("--compress-threads needs --compress=zstd");
+
+  if (server_outfile){
+    if (output_format!=LOAD_DATA && output_format!=CSV)
+      m_critical("--server-outfile is only supported with --format=LOAD_DATA or --format=CSV");
+    if (include_header)
+      m_critical("--server-outfile is not compatible with --include-header");
+    if (compress_method!=NULL || exec_per_thread!=NULL || encryption_key_file || coalesce_tables > 0 || chunk_filesize > 0)
+      m_critical("--server-outfile is not compatible with --compress, --exec-per-thread, --encryption-key-file, --coalesce-tables or --chunk-filesize");
+  }
+
+  if (encryption_key_file){
+    if (output_format!=SQL_INSERT)
+      m_critical("--encryption-key-file is only supported with --format=INSERT");
+    if (coalesce_tables > 0 || zstd_frame_size > 0 || zstd_dictionary_samples > 0)
+      m_critical("--encryption-key-file is not compatible with --coalesce-tables, --zstd-frame-size or --zstd-dictionary");
+    initialize_encryption();
+  }
+
+  if (transportable_tablespace_size > 0){
+    if (stream || daemon_mode)
+      m_critical("--transportable-tablespace-size is not compatible with --stream or --daemon");
+    if (encryption_key_file)
+      m_critical("--transportable-tablespace-size is not compatible with --encryption-key-file");
+    if (sync_thread_lock_mode==NO_LOCK || sync_thread_lock_mode==SAFE_NO_LOCK || sync_thread_lock_mode==GTID)
+      m_critical("--transportable-tablespace-size needs a global lock, it is not compatible with --sync-thread-lock-mode NO_LOCK, SAFE_NO_LOCK or GTID");
+  }
+
+  if (coalesce_tables > 0){
+    if (output_format!=SQL_INSERT)
+      m_critical("--coalesce-tables is only supported with --format=INSERT");
+    if (compress_method!=NULL || exec_per_thread!=NULL)
+      m_critical("--coalesce-tables is not compatible with --compress or --exec-per-thread");
+  }
+
   if (compress_method==NULL && exec_per_thread==NULL) {
     exec_per_thread_extension=EMPTY_STRING;
   }else{
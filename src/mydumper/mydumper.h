@@ -30,3 +30,4 @@
 #include "../server_detect.h"
 #include "../pmm_thread.h"
 #include "../checksum.h"
+#include "../encryption.h"
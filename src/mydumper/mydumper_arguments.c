@@ -35,14 +35,23 @@ guint max_items_per_string_chunk=5;
 guint max_time_per_select=MAX_TIME_PER_SELECT;
 enum sync_thread_lock_mode sync_thread_lock_mode=AUTO;
 const gchar *compress_method=NULL;
+guint zstd_dictionary_samples=0;
+guint zstd_frame_size=0;
+guint compress_threads=0;
+guint coalesce_tables=0;
 gboolean split_integer_tables=TRUE;
 const gchar *rows_file_extension=SQL;
 enum output_format output_format=SQL_INSERT;
 gchar *output_directory_str = NULL;
 gboolean masquerade_filename=FALSE;
+gchar *masquerade_key=NULL;
 guint trx_tables=1;
 gboolean use_single_column=FALSE;
 gboolean split_string_pk=FALSE;
+gboolean string_pk_sampling=FALSE;
+gboolean use_histograms=FALSE;
+gboolean async_write=FALSE;
+guint max_memory=0;
 const gchar *table_engine_for_view_dependency=MEMORY;
 guint ftwrl_max_wait_time=60;
 guint ftwrl_timeout_retries=0;
@@ -200,6 +209,9 @@ static GOptionEntry entries[] = {
       "resume if 500MB are available", NULL },
     {"masquerade-filename", 0, 0, G_OPTION_ARG_NONE, &masquerade_filename,
       "Masquerades the filenames", NULL},
+    {"masquerade-key", 0, 0, G_OPTION_ARG_STRING, &masquerade_key,
+      "Key used by the hash_* masquerade functions. The same key gives the same "
+      "replacement for a value on every table and on every run. Default: random key per run", NULL},
     {"ftwrl-max-wait-time", 0, 0, G_OPTION_ARG_INT, &ftwrl_max_wait_time,
       "Sets the max time that we are going to wait before kill the FLUSH TABLES related commands. Default: 60", NULL},
     {"ftwrl-timeout-retries", 0, 0, G_OPTION_ARG_INT, &ftwrl_timeout_retries,
@@ -211,6 +223,13 @@ static GOptionEntry entries[] = {
 static GOptionEntry extra_entries[] = {
     {"chunk-filesize", 'F', 0, G_OPTION_ARG_INT, &chunk_filesize,
       "Split data files into pieces of this size in MB. Useful for myloader multi-threading.", NULL},
+    {"coalesce-tables", 0, 0, G_OPTION_ARG_INT, &coalesce_tables,
+      "Tables with less than this size in MB are dumped in one job into a bundle file shared with other small tables, "
+      "instead of into their own data files. Only for --format=INSERT without compression. Default: 0, disabled", NULL},
+    {"transportable-tablespace-size", 0, 0, G_OPTION_ARG_INT, &transportable_tablespace_size,
+      "InnoDB tables with at least this size in MB are exported with FLUSH TABLES ... FOR EXPORT and their .ibd and .cfg files are copied "
+      "into the backup instead of dumping their rows. mydumper must be able to read the datadir. "
+      "Tables with a where, limit, partition_regex or masquerade functions are dumped as rows. Default: 0, disabled", NULL},
     {"exit-if-broken-table-found", 0, 0, G_OPTION_ARG_NONE, &exit_if_broken_table_found,
       "Exits if a broken table has been found", NULL},
     {"build-empty-files", 'e', 0, G_OPTION_ARG_NONE, &build_empty_files,
@@ -219,7 +238,7 @@ static GOptionEntry extra_entries[] = {
       "Queries related to generated fields are not going to be executed."
       "It will lead to restoration issues if you have generated columns", NULL },
     { "bulk-metadata-prefetch", 0, 0, G_OPTION_ARG_NONE, &bulk_metadata_prefetch,
-      "Prefetch JSON and generated column metadata in bulk at startup. "
+      "Prefetch collations, JSON and generated columns, indexes and triggers of all the tables in bulk at startup. "
       "Significantly faster for dumping many tables, but slower for small dumps with -T", NULL },
     {"order-by-primary", 0, 0, G_OPTION_ARG_NONE, &order_by_primary_key,
       "Sort the data by Primary Key or Unique key if no primary key exists", NULL},
@@ -227,6 +246,15 @@ static GOptionEntry extra_entries[] = {
       "Give less verbose output. Disables header/footer constructs.", NULL},
     {"compress", 'c', G_OPTION_FLAG_OPTIONAL_ARG, G_OPTION_ARG_CALLBACK , &arguments_callback,
       "Compress output files using: gzip and zstd. Options: gzip and zstd. Default: gzip. On future releases the default will be zstd", NULL},
+    {"zstd-dictionary", 0, 0, G_OPTION_ARG_INT, &zstd_dictionary_samples,
+      "Trains a zstd dictionary with the first N files of the dump and compresses all the files with it. "
+      "Useful when there are many small files. Requires --compress=zstd. Default: 0, no dictionary", NULL},
+    {"zstd-frame-size", 0, 0, G_OPTION_ARG_INT, &zstd_frame_size,
+      "Splits the data files in independent zstd frames of this uncompressed size in MB and appends a seek table, "
+      "which allows myloader to restore a file in parallel. Requires --compress=zstd. Default: 0, one frame per file", NULL},
+    {"compress-threads", 0, 0, G_OPTION_ARG_INT, &compress_threads,
+      "Maximum amount of zstd worker threads shared by all the compressed files. A file gets more workers when less files are open. "
+      "Requires --compress=zstd. Default: 0, one thread per compressed file", NULL},
     {"use-defer", 0, 0, G_OPTION_ARG_NONE, &use_defer,
       "Use defer integer sharding until all non-integer PK tables processed (saves RSS for huge quantities of tables)", NULL},
     {"check-row-count", 0, 0, G_OPTION_ARG_NONE, &check_row_count,
@@ -293,8 +321,13 @@ static GOptionEntry chunks_entries[] = {
       "It will ignore if the table has multiple columns and use only the first column to split the table", NULL},
     {"split-string-pk", 0, 0, G_OPTION_ARG_NONE, &split_string_pk,
       "Enables the split of string primary keys", NULL},
+    {"string-pk-sampling", 0, 0, G_OPTION_ARG_NONE, &string_pk_sampling,
+      "Computes the chunks of string primary keys up-front from a sample of the index, instead of probing the boundaries on each split. Requires --split-string-pk", NULL},
+    {"use-histograms", 0, 0, G_OPTION_ARG_NONE, &use_histograms,
+      "Places the first chunks of integer primary keys at the quantiles of the column histogram, when it exists (MySQL 8.0+, ANALYZE TABLE ... UPDATE HISTOGRAM)", NULL},
     {"rows", 'r', 0, G_OPTION_ARG_CALLBACK, &arguments_callback,
-      "Splitting tables into chunks of this many rows. It can be MIN:START_AT:MAX. MAX can be 0 which means that there is no limit. It will double the chunk size if query takes less than 1 second and half of the size if it is more than 2 seconds", NULL},
+      "Splitting tables into chunks of this many rows. It can be MIN:START_AT:MAX. MAX can be 0 which means that there is no limit. It will double the chunk size if query takes less than 1 second and half of the size if it is more than 2 seconds. "
+      "Composite primary keys are split on their integer columns, on their string columns with --split-string-pk, and on their DATE, DATETIME and TIMESTAMP columns after the first one. Any other type ends the nesting", NULL},
     {"rows-hard", 0, 0, G_OPTION_ARG_CALLBACK, &arguments_callback, 
       "This set the MIN and MAX limit when even if --rows is 0", NULL},
     {"max-split-of-step-in-integer-chunk", 0, 0, G_OPTION_ARG_INT, &max_split_of_step_in_integer_chunk,
@@ -368,6 +401,10 @@ static GOptionEntry statement_entries[] = {
       "Default: INSERT", NULL },
     {"include-header", 0, 0, G_OPTION_ARG_NONE, &include_header, 
       "When --format is CSV or LOAD_DATA, it will include the header with the column name", NULL},
+    {"server-outfile", 0, 0, G_OPTION_ARG_NONE, &server_outfile,
+      "When --format is CSV or LOAD_DATA, the server writes the data files with SELECT ... INTO OUTFILE. "
+      "mydumper must run on the database host, and the files are moved from secure_file_priv to the output directory when it is set. "
+      "Tables with masquerade functions are dumped by mydumper", NULL},
     {"fields-terminated-by", 0, 0, G_OPTION_ARG_STRING, &fields_terminated_by_ld,
       "Defines the character that is written between fields", NULL },
     {"fields-enclosed-by", 0, 0, G_OPTION_ARG_STRING, &fields_enclosed_by_ld,
@@ -399,6 +436,11 @@ static GOptionEntry statement_entries[] = {
      "Replaces the user in the DEFINER by the new string. By default, statements are not modified", NULL},
     {"statement-size", 's', 0, G_OPTION_ARG_INT, &statement_size,
       "Attempted size of INSERT statement in bytes, default 1000000", NULL},
+    {"max-memory", 0, 0, G_OPTION_ARG_INT, &max_memory,
+      "Memory in MB that the row and statement buffers of all the threads can use. A thread waits before dumping "
+      "a new chunk while the budget is exceeded by buffers that grew on big rows. Default: 0, no limit", NULL},
+    {"async-write", 0, 0, G_OPTION_ARG_NONE, &async_write,
+      "Data files are written by a separate thread per worker, so the worker keeps fetching rows while the previous statement is written", NULL},
     {"tz-utc", 0, G_OPTION_FLAG_REVERSE, G_OPTION_ARG_NONE, &skip_tz,
       "SET TIME_ZONE='+00:00' at top of dump to allow dumping of TIMESTAMP data "
       "when a server has data in different time zones or data is being moved "
@@ -35,10 +35,45 @@
 
 extern guint64 min_integer_chunk_step_size;
 extern gboolean split_string_pk;
+extern gboolean string_pk_sampling;
+extern gboolean use_histograms;
 GAsyncQueue *give_me_another_transactional_chunk_step_queue;
 GAsyncQueue *give_me_another_non_transactional_chunk_step_queue;
 GThread *chunk_builder=NULL;
 
+// The chunk builder waits on this counter when it has no chunk to give,
+// instead of spinning, until a table changes its state: its chunk
+// strategy is decided or a thread finishes a chunk of it.
+static GMutex *chunk_builder_mutex=NULL;
+static GCond *chunk_builder_cond=NULL;
+static guint chunk_builder_events=0;
+
+void notify_chunk_builder(){
+  g_mutex_lock(chunk_builder_mutex);
+  chunk_builder_events++;
+  g_cond_broadcast(chunk_builder_cond);
+  g_mutex_unlock(chunk_builder_mutex);
+}
+
+static
+guint get_chunk_builder_events(){
+  g_mutex_lock(chunk_builder_mutex);
+  guint events=chunk_builder_events;
+  g_mutex_unlock(chunk_builder_mutex);
+  return events;
+}
+
+// The timeout is only a safety net, every state change notifies
+static
+void wait_for_chunk_builder_event(guint events){
+  gint64 end_time=g_get_monotonic_time() + 100 * G_TIME_SPAN_MILLISECOND;
+  g_mutex_lock(chunk_builder_mutex);
+  while (chunk_builder_events == events && !shutdown_triggered)
+    if (!g_cond_wait_until(chunk_builder_cond, chunk_builder_mutex, end_time))
+      break;
+  g_mutex_unlock(chunk_builder_mutex);
+}
+
 
 GString * get_where_from_csi(struct chunk_step_item * csi){
   GString *where = NULL;
@@ -61,6 +96,8 @@ GString * get_where_from_csi(struct chunk_step_item * csi){
 void initialize_chunk(){
   give_me_another_transactional_chunk_step_queue=g_async_queue_new();
   give_me_another_non_transactional_chunk_step_queue=g_async_queue_new();
+  chunk_builder_mutex=g_mutex_new();
+  chunk_builder_cond=g_cond_new();
 }
 
 void start_chunk_builder(struct configuration *conf){
@@ -103,8 +140,8 @@ double log_base(double base, double x) {
 
 struct chunk_step_item * initialize_chunk_step_item (MYSQL *conn, struct db_table *dbt, guint position, guint64 rows, GString *prefix) {
 
-  // We do not support more that 2 levels of multi column pk
-  if (position>=2)
+  // Every column of the primary key can be a level of nested chunks
+  if (position>=g_list_length(dbt->primary_key))
     return NULL;
 
   struct chunk_step_item * csi=NULL;
@@ -153,8 +190,9 @@ struct chunk_step_item * initialize_chunk_step_item (MYSQL *conn, struct db_tabl
       gboolean unsign = fields[0].flags & UNSIGNED_FLAG;
       guint64 gap_btwn_min_max = unsign ? gint64_abs(unmax-unmin) : gint64_abs(nmax-nmin); 
 
-      // If !(gap_btwn_min_max > min_chunk_step_size), then there is no need to split the table.
-      if ( gap_btwn_min_max > dbt->min_chunk_step_size){
+      // If !(gap_btwn_min_max > min_chunk_step_size), then there is no need to split the table,
+      // unless it is a nested level and we can still go deeper on the next columns
+      if ( gap_btwn_min_max > dbt->min_chunk_step_size || (position > 0 && position + 1 < g_list_length(dbt->primary_key))){
         trace("Integer PK found on `%s`.`%s`",dbt->database->source_database, dbt->table);
         union type type;
 
@@ -192,11 +230,17 @@ struct chunk_step_item * initialize_chunk_step_item (MYSQL *conn, struct db_tabl
         }
         if (_starting_chunk_step_size < dbt->min_chunk_step_size)
           _starting_chunk_step_size=dbt->min_chunk_step_size;
+        // A nested level with a single value still needs a step to go deeper
+        if (_starting_chunk_step_size == 0)
+          _starting_chunk_step_size=1;
 
         trace("starting_chunk_step_size: `%s`.`%s` %d", dbt->database->source_database, dbt->table, _starting_chunk_step_size);
         g_assert(_starting_chunk_step_size>0);
 
-        csi = new_integer_step_item( TRUE, prefix, field, unsign, type, 0, dbt->is_fixed_length, _starting_chunk_step_size, dbt->min_chunk_step_size, dbt->max_chunk_step_size, 0, FALSE, FALSE, NULL, position, dbt->multicolumn, rows);
+        if (use_histograms && position==0 && !dbt->is_fixed_length)
+          csi = new_histogram_integer_step_items(conn, dbt, prefix, field, unsign, type, rows, _starting_chunk_step_size);
+        if (!csi)
+          csi = new_integer_step_item( TRUE, prefix, field, unsign, type, 0, dbt->is_fixed_length, _starting_chunk_step_size, dbt->min_chunk_step_size, dbt->max_chunk_step_size, 0, FALSE, FALSE, NULL, position, dbt->multicolumn, rows);
 
         if (csi->chunk_step->integer_step.is_step_fixed_length){
           if (csi->chunk_step->integer_step.is_unsigned){
@@ -211,8 +255,8 @@ struct chunk_step_item * initialize_chunk_step_item (MYSQL *conn, struct db_tabl
     case MYSQL_TYPE_STRING:
     case MYSQL_TYPE_VAR_STRING:
 
-      if (position>0){
-        // We do not support a second level of string column pk
+      if (position>0 && !split_string_pk){
+        // Nested string levels are only split when string primary keys are
         trace("Disabling multicolum on `%s`.`%s`",dbt->database->source_database, dbt->table);
         dbt->multicolumn=FALSE;
         goto cleanup;
@@ -236,7 +280,37 @@ struct chunk_step_item * initialize_chunk_step_item (MYSQL *conn, struct db_tabl
                                              rows/num_threads;
       }
 
-        csi=new_string_step_item( TRUE, prefix, field, 0, dbt->is_fixed_length, 1, str_min, str_max, _starting_chunk_step_size, 0, FALSE, FALSE, NULL, position, dbt->multicolumn, rows);
+        if (position>0){
+          // The boundary probes do not honor the prefix, so nested string
+          // levels are always split on a sample of the values under it
+          g_free(str_min);
+          g_free(str_max);
+          csi=new_nested_sampled_string_step_item(conn, dbt, prefix, field, position, rows, _starting_chunk_step_size);
+          break;
+        }
+        if (string_pk_sampling && !dbt->is_fixed_length)
+          csi=new_sampled_string_step_items(conn, dbt, prefix, field, rows, _starting_chunk_step_size);
+        if (csi){
+          g_free(str_min);
+          g_free(str_max);
+        }else
+          csi=new_string_step_item( TRUE, prefix, field, 0, dbt->is_fixed_length, 1, str_min, str_max, _starting_chunk_step_size, 0, FALSE, FALSE, NULL, position, dbt->multicolumn, rows);
+      }
+      break;
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_TIMESTAMP:
+      // Nested temporal levels are split on a sample of their values, which
+      // the server compares with the column in the format that it returns.
+      // The first column of the key is not split.
+      if (position>0){
+        trace("Temporal column %s found on `%s`.`%s`", field, dbt->database->source_database, dbt->table);
+        guint64 _starting_chunk_step_size=dbt->starting_chunk_step_size;
+        if (_starting_chunk_step_size == 0)
+          _starting_chunk_step_size= dbt->max_chunk_step_size!=0 && rows/num_threads>dbt->max_chunk_step_size ?
+                                       dbt->max_chunk_step_size:
+                                       rows/num_threads;
+        csi=new_nested_sampled_string_step_item(conn, dbt, prefix, field, position, rows, _starting_chunk_step_size);
       }
       break;
     default:
@@ -256,6 +330,53 @@ cleanup:
 }
 
 
+// Integer levels can go deeper while there are primary key columns left
+gboolean can_go_deeper_on_chunk_step_item(struct db_table *dbt, struct chunk_step_item *csi){
+  return csi->chunk_type==INTEGER && csi->position + 1 < g_list_length(dbt->primary_key);
+}
+
+// Nested levels are reused for every value of the prefix, so before going down
+// we need to recalculate where the level starts and ends
+gboolean refresh_chunk_step_item(MYSQL *conn, struct db_table *dbt, struct chunk_step_item *csi){
+  // Stage 2 could have disabled it while processing the previous prefix
+  csi->multicolumn=can_go_deeper_on_chunk_step_item(dbt, csi);
+  switch (csi->chunk_type){
+    case INTEGER:
+      return refresh_integer_min_max(conn, dbt, csi);
+    case STRING:
+      return csi->chunk_step->string_step.fixed_boundaries ?
+               refresh_sampled_string_boundaries(conn, dbt, csi):
+               refresh_string_min_max(conn, dbt, csi);
+    default:
+      return FALSE;
+  }
+}
+
+// When the key picked by get_primary_key() can not be used to split the table,
+// we try with the first column of the other indexes and the invisible primary key
+static
+struct chunk_step_item *initialize_chunk_step_item_on_candidates(MYSQL *conn, struct db_table *dbt, guint64 rows){
+  struct chunk_step_item *csi=NULL;
+  GList *primary_key=dbt->primary_key;
+  gboolean multicolumn=dbt->multicolumn;
+  GList *l;
+  for (l=dbt->chunk_key_candidates; l; l=l->next){
+    dbt->primary_key=g_list_append(NULL, g_strdup(l->data));
+    dbt->multicolumn=FALSE;
+    csi=initialize_chunk_step_item(conn, dbt, 0, rows, NULL);
+    if (csi->chunk_type != NONE){
+      g_message("`%s`.`%s` has no usable primary key, it will be split using column %s", dbt->database->source_database, dbt->table, (gchar *)l->data);
+      g_list_free_full(primary_key, g_free);
+      return csi;
+    }
+    g_free(csi);
+    g_list_free_full(dbt->primary_key, g_free);
+  }
+  dbt->primary_key=primary_key;
+  dbt->multicolumn=multicolumn;
+  return NULL;
+}
+
 guint64 get_rows_from_explain(MYSQL * conn, struct db_table *dbt, GString *where, gchar *field){
   gchar *query = g_strdup_printf(
                         "EXPLAIN SELECT %s %s%s%s FROM %s%s%s.%s%s%s%s%s",
@@ -320,7 +441,7 @@ void set_chunk_strategy_for_dbt(MYSQL *conn, struct db_table *dbt){
   g_message("%s.%s has %s%"G_GINT64_FORMAT" rows", dbt->database->source_database, dbt->table,
             (check_row_count ? "": "~"), rows);
   dbt->rows_total= rows;
-  if (rows > dbt->min_chunk_step_size){
+  if (rows > dbt->min_chunk_step_size && !dbt->coalesce){
     GList *partitions=NULL;
     if (split_partitions || dbt->partition_regex){
       partitions = get_partitions_for_table(conn, dbt);
@@ -329,7 +450,14 @@ void set_chunk_strategy_for_dbt(MYSQL *conn, struct db_table *dbt){
       csi=new_real_partition_step_item(partitions,0,0);
     }else{
       if (dbt->split_integer_tables) {
-        csi = initialize_chunk_step_item(conn, dbt, 0, rows, NULL);
+        csi = dbt->primary_key ? initialize_chunk_step_item(conn, dbt, 0, rows, NULL) : new_none_chunk_step();
+        if (csi->chunk_type == NONE && dbt->chunk_key_candidates){
+          struct chunk_step_item *candidate_csi = initialize_chunk_step_item_on_candidates(conn, dbt, rows);
+          if (candidate_csi){
+            g_free(csi);
+            csi=candidate_csi;
+          }
+        }
       }else{
         csi = new_none_chunk_step();
       }
@@ -342,104 +470,100 @@ void set_chunk_strategy_for_dbt(MYSQL *conn, struct db_table *dbt){
   g_async_queue_push(dbt->chunks_queue, csi);
   dbt->status=READY;
   g_mutex_unlock(dbt->chunks_mutex);
+  notify_chunk_builder();
 }
 
+// Tables are visited in order once per request, stopping at the first
+// table that is UNDEFINED, a full table scan or has no threads running.
+// Otherwise, the chunk comes from the READY table with less threads
+// running on it.
 static
 void get_next_dbt_and_chunk_step_item(struct db_table **dbt_pointer,struct chunk_step_item **csi, struct MList *dbt_list, gboolean *are_there_jobs_defining, gboolean *are_string_tables_processing, gboolean *max_threads_per_table_reached){
-  GList *iter=dbt_list->list;
-  struct db_table *dbt;
+  GList *iter=NULL;
+  struct db_table *dbt, *candidate;
+  guint candidate_threads_running=0;
   *are_there_jobs_defining=FALSE;
   *are_string_tables_processing=FALSE;
   struct chunk_step_item *lcs;
 
-  gboolean finish=FALSE;
-  guint current_max_threads_running=0;
-  for (current_max_threads_running=0; current_max_threads_running < max_threads_per_table && !finish; current_max_threads_running++){
-//    g_message("Current current_max_threads_running: %d %d", current_max_threads_running, max_threads_per_table);
-
-    g_mutex_lock(dbt_list->mutex);
-    iter=dbt_list->list;
-  //  struct chunk_step_item *(*get_next)(struct db_table *dbt);
-    while (iter && !finish){
+  g_mutex_lock(dbt_list->mutex);
+  for (;;){
+    candidate=NULL;
+    for (iter=dbt_list->list; iter; iter=iter->next){
       dbt=iter->data;
       g_mutex_lock(dbt->chunks_mutex);
-//    g_message("Checking table: %s.%s", d->database->source_database, d->table);
-      if (dbt->status != DEFINING){
-
-        if (dbt->status == UNDEFINED){
-//        g_message("Checking table: %s.%s DEFINING NOW", d->database->source_database, d->table);
-          *dbt_pointer=iter->data;
-          dbt->status = DEFINING;
-          *are_there_jobs_defining=TRUE;
-          g_mutex_unlock(dbt->chunks_mutex);
-          finish=TRUE;
-          goto next;
-        }
-
-        // Set by set_chunk_strategy_for_dbt() in working_thread()
-        g_assert(dbt->status == READY);
-
-        // Initially chunks are set by set_chunk_strategy_for_dbt() and then by
-        // chunk_functions.get_next(d) (see below)
-        if (dbt->chunks == NULL){
-          g_mutex_unlock(dbt->chunks_mutex);
-          goto next;
-        }
+      if (dbt->status == DEFINING){
+        *are_there_jobs_defining=TRUE;
+        g_mutex_unlock(dbt->chunks_mutex);
+        continue;
+      }
 
-        // Reading first chunk 
-        lcs = (struct chunk_step_item *)g_list_first(dbt->chunks)->data;
-        // If it is a full table scan, we assign it and exit
-        if (lcs->chunk_type == NONE){
-          *dbt_pointer=iter->data;
-          *csi = lcs;
-          dbt_list->list=g_list_remove(dbt_list->list,dbt);
-          g_mutex_unlock(dbt->chunks_mutex);
-          finish=TRUE;
-          goto next;
-        }
+      if (dbt->status == UNDEFINED){
+        *dbt_pointer=dbt;
+        dbt->status = DEFINING;
+        *are_there_jobs_defining=TRUE;
+        g_mutex_unlock(dbt->chunks_mutex);
+        goto end;
+      }
 
-        // if we reach the max limit of threads per table, we continue with next table
-        if (dbt->max_threads_per_table <= dbt->current_threads_running){
-          *max_threads_per_table_reached=TRUE;
-          g_mutex_unlock(dbt->chunks_mutex);
-          goto next;
-        }
+      // Set by set_chunk_strategy_for_dbt() in working_thread()
+      g_assert(dbt->status == READY);
 
-        if (dbt->current_threads_running > current_max_threads_running ){
-          *max_threads_per_table_reached=TRUE;
-          g_mutex_unlock(dbt->chunks_mutex);
-          goto next;
-        }
+      // Initially chunks are set by set_chunk_strategy_for_dbt() and then by
+      // chunk_functions.get_next(d) (see below)
+      if (dbt->chunks == NULL){
+        g_mutex_unlock(dbt->chunks_mutex);
+        continue;
+      }
 
-        lcs=lcs->chunk_functions.get_next(dbt);
+      // If it is a full table scan, we assign it and exit
+      lcs = (struct chunk_step_item *)g_list_first(dbt->chunks)->data;
+      if (lcs->chunk_type == NONE){
+        *dbt_pointer=dbt;
+        *csi = lcs;
+        dbt_list->list=g_list_remove(dbt_list->list,dbt);
+        g_mutex_unlock(dbt->chunks_mutex);
+        goto end;
+      }
 
-        if (lcs!=NULL){
-          dbt->current_threads_running++;
-          *dbt_pointer=iter->data;
-          *csi = lcs;
-          g_mutex_unlock(dbt->chunks_mutex);
-          finish=TRUE;
-          goto next;
-        }else{
-          trace("get_next_dbt_and_chunk_step_item :: get null for %s", dbt->table);
-          // If there is no more chunks on this table, we remove it from the list, and continue with the next table
-          iter=iter->next;
-          // Assign iter previous removing dbt from list is important as we might break the list
-          dbt_list->list=g_list_remove(dbt_list->list,dbt);
-          g_mutex_unlock(dbt->chunks_mutex);
-          // we just continue as iter has been already set
-         continue;
-        }
-      }else{
+      // if we reach the max limit of threads per table, we continue with next table
+      if (dbt->max_threads_per_table <= dbt->current_threads_running){
+        *max_threads_per_table_reached=TRUE;
         g_mutex_unlock(dbt->chunks_mutex);
-        *are_there_jobs_defining=TRUE;
+        continue;
+      }
+
+      if (candidate == NULL || dbt->current_threads_running < candidate_threads_running){
+        candidate=dbt;
+        candidate_threads_running=dbt->current_threads_running;
       }
-next:
-      iter=iter->next;
+      g_mutex_unlock(dbt->chunks_mutex);
+      // No table can have less threads running
+      if (candidate_threads_running == 0)
+        break;
     }
-    g_mutex_unlock(dbt_list->mutex);
 
+    if (candidate == NULL)
+      break;
+
+    // Only this thread increases current_threads_running, so the table is
+    // still below its limit
+    g_mutex_lock(candidate->chunks_mutex);
+    lcs=((struct chunk_step_item *)g_list_first(candidate->chunks)->data)->chunk_functions.get_next(candidate);
+    if (lcs!=NULL){
+      candidate->current_threads_running++;
+      *dbt_pointer=candidate;
+      *csi = lcs;
+      g_mutex_unlock(candidate->chunks_mutex);
+      break;
+    }
+    trace("get_next_dbt_and_chunk_step_item :: get null for %s", candidate->table);
+    // If there is no more chunks on this table, we remove it from the list, and look for another table
+    dbt_list->list=g_list_remove(dbt_list->list,candidate);
+    g_mutex_unlock(candidate->chunks_mutex);
   }
+end:
+  g_mutex_unlock(dbt_list->mutex);
 }
 
 static
@@ -460,21 +584,49 @@ void enqueue_shutdown(struct table_queuing *q)
   enqueue_shutdown_jobs(q->defer);
 }
 
+static
+gint compare_dbt_by_data_length(gconstpointer a, gconstpointer b){
+  const struct db_table *dbt_a=a, *dbt_b=b;
+  if (dbt_a->data_length == dbt_b->data_length)
+    return 0;
+  return dbt_a->data_length > dbt_b->data_length ? -1 : 1;
+}
+
+// Largest tables go first, so the long tail of a dump is spent on small
+// tables that fit in the gaps instead of on a big table started last.
+// Table discovery is over by the time the first chunk is requested.
+static
+void sort_tables_by_data_length(struct MList *dbt_list){
+  g_mutex_lock(dbt_list->mutex);
+  dbt_list->list=g_list_sort(dbt_list->list, compare_dbt_by_data_length);
+  if (dbt_list->list){
+    struct db_table *dbt=dbt_list->list->data;
+    trace("sort_tables_by_data_length: `%s`.`%s` is the largest table with %"G_GUINT64_FORMAT" bytes", dbt->database->source_database, dbt->table, dbt->data_length);
+  }
+  g_mutex_unlock(dbt_list->mutex);
+}
+
 static
 void table_job_enqueue(struct table_queuing *q)
 {
   struct db_table *dbt;
   struct chunk_step_item *csi;
-  gboolean are_there_jobs_defining=FALSE, are_string_tables_processing=FALSE, max_threads_per_table_reached=FALSE;
+  gboolean are_there_jobs_defining=FALSE, are_string_tables_processing=FALSE, max_threads_per_table_reached=FALSE, sorted=FALSE;
+  guint events=0;
   g_message("Starting to enqueue %s tables", q->descr);
   for (;;) {
     g_async_queue_pop(q->request_chunk);
     if (shutdown_triggered) {
       break;
     }
+    if (!sorted){
+      sort_tables_by_data_length(q->table_list);
+      sorted=TRUE;
+    }
     dbt=NULL;
     csi=NULL;
     max_threads_per_table_reached=FALSE;
+    events=get_chunk_builder_events();
     get_next_dbt_and_chunk_step_item(&dbt, &csi, q->table_list, &are_there_jobs_defining, &are_string_tables_processing, &max_threads_per_table_reached);
 
     if (dbt!=NULL){
@@ -510,14 +662,14 @@ void table_job_enqueue(struct table_queuing *q)
       }
     }else{
       if (are_there_jobs_defining || max_threads_per_table_reached){
-        trace("table_job_enqueue: Are jobs defining or Max threads reached, try again later?");
+        trace("table_job_enqueue: Are jobs defining or Max threads reached, waiting for a table to change");
         g_async_queue_push(q->request_chunk, GINT_TO_POINTER(1));
-        usleep(1);
+        wait_for_chunk_builder_event(events);
         continue;
       }
       if (are_string_tables_processing){
         g_async_queue_push(q->request_chunk, GINT_TO_POINTER(1));
-        usleep(1);
+        wait_for_chunk_builder_event(events);
         continue;      
       }
 //      g_debug("chunk_builder_thread: There were not job defined");
@@ -92,6 +92,7 @@ void set_chunk_strategy_for_dbt(MYSQL *conn, struct db_table *dbt);
 void free_integer_step(union chunk_step * cs);
 union chunk_step *get_next_chunk(struct db_table *dbt);
 void *chunk_builder_thread(struct configuration *conf);
+void notify_chunk_builder();
 void finalize_chunk();
 extern GAsyncQueue *give_me_another_transactional_chunk_step_queue;
 extern GAsyncQueue *give_me_another_non_transactional_chunk_step_queue;
@@ -100,3 +101,5 @@ void build_where_clause_on_table_job(struct table_job *tj);
 guint64 get_rows_from_explain(MYSQL * conn, struct db_table *dbt, GString *where, gchar *field);
 guint64 get_rows_from_count(MYSQL * conn, struct db_table *dbt, GString *where);
 GString * get_where_from_csi(struct chunk_step_item * csi);
+gboolean can_go_deeper_on_chunk_step_item(struct db_table *dbt, struct chunk_step_item *csi);
+gboolean refresh_chunk_step_item(MYSQL *conn, struct db_table *dbt, struct chunk_step_item *csi);
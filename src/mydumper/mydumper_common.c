@@ -218,6 +218,13 @@ gchar * build_rows_filename(char *database, char *table, guint64 part, guint sub
   return build_filename(database, table, part, sub_part, rows_file_extension, NULL);
 }
 
+gchar * build_bundle_filename(guint thread_id, guint number){
+  gchar *filename = g_strdup_printf("%s%u_%05u.%s", BUNDLE_PREFIX, thread_id, number, SQL);
+  gchar *r = g_build_filename(dump_directory, filename, NULL);
+  g_free(filename);
+  return r;
+}
+
 unsigned long m_real_escape_string(MYSQL *conn, char *to, const gchar *from, unsigned long length){
   (void) conn;
   (void) to;
@@ -359,7 +366,7 @@ void m_replace_char_with_char(gchar needle, gchar repl, gchar *str, unsigned lon
   }
 }
 
-void determine_show_table_status_columns(MYSQL_RES *result, guint *ecol, guint *ccol, guint *collcol, guint *rowscol){
+void determine_show_table_status_columns(MYSQL_RES *result, guint *ecol, guint *ccol, guint *collcol, guint *rowscol, guint *dlcol){
   MYSQL_FIELD *fields = mysql_fetch_fields(result);
   guint i = 0;
   for (i = 0; i < mysql_num_fields(result); i++) {
@@ -371,6 +378,8 @@ void determine_show_table_status_columns(MYSQL_RES *result, guint *ecol, guint *
       *collcol = i;
     else if (!strcasecmp(fields[i].name, "Rows"))
       *rowscol = i;
+    else if (!strcasecmp(fields[i].name, "Data_length"))
+      *dlcol = i;
   }
   g_assert(*ecol > 0);
   g_assert(*ccol > 0);
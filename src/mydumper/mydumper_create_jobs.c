@@ -28,6 +28,8 @@
 #include "mydumper_arguments.h"
 #include "mydumper_create_jobs.h"
 #include "mydumper_chunks.h"
+#include "mydumper_write.h"
+#include "mydumper_file_handler.h"
 //
 // Enqueueing in initial_queue
 //
@@ -39,7 +41,7 @@ void initialize_create_jobs(struct configuration *_conf){
 }
 
 
-void create_job_to_dump_table(gboolean is_view, gboolean is_sequence, struct database *database, gchar *table, gchar *collation, gchar *engine){
+void create_job_to_dump_table(gboolean is_view, gboolean is_sequence, struct database *database, gchar *table, gchar *collation, gchar *engine, guint64 data_length){
   struct job *j = g_new0(struct job, 1);
   struct dump_table_job *dtj= g_new0(struct dump_table_job, 1);
   dtj->is_view=is_view;
@@ -48,6 +50,7 @@ void create_job_to_dump_table(gboolean is_view, gboolean is_sequence, struct dat
   dtj->table=table;
   dtj->collation=collation;
   dtj->engine=engine;
+  dtj->data_length=data_length;
   j->job_data = dtj;
   j->type = JOB_TABLE;
   g_async_queue_push(local_conf->initial_queue, j);
@@ -139,22 +142,27 @@ void create_job_to_dump_post(struct database *database) {
 //
 
 void create_job_to_dump_triggers(MYSQL *conn, struct db_table *dbt) {
-  gchar *query = g_strdup_printf("SHOW TRIGGERS FROM %c%s%c LIKE '%s'", identifier_quote_character, dbt->database->source_database, identifier_quote_character, dbt->escaped_table);
-
-  MYSQL_RES *result = m_store_result(conn, query, m_critical, "Error Checking triggers for %s.%s. St: %s", dbt->database->source_database, dbt->table, query);
-  g_free(query);
-
-  if (result) {
-    if (mysql_num_rows(result)) {
-      struct job *t = g_new0(struct job, 1);
-      struct schema_job *st = g_new0(struct schema_job, 1);
-      t->job_data = (void *)st;
-      t->type = JOB_TRIGGERS;
-      st->dbt = dbt;
-      st->filename = build_schema_table_filename(dbt->database->database_name_in_filename, dbt->table_filename, "schema-triggers");
-      g_async_queue_push(local_conf->post_data_queue, t);
+  gboolean has_triggers=FALSE;
+  if (!get_has_triggers_from_catalog(dbt, &has_triggers)){
+    gchar *query = g_strdup_printf("SHOW TRIGGERS FROM %c%s%c LIKE '%s'", identifier_quote_character, dbt->database->source_database, identifier_quote_character, dbt->escaped_table);
+
+    MYSQL_RES *result = m_store_result(conn, query, m_critical, "Error Checking triggers for %s.%s. St: %s", dbt->database->source_database, dbt->table, query);
+    g_free(query);
+
+    if (result) {
+      has_triggers=mysql_num_rows(result) > 0;
+      mysql_free_result(result);
     }
-    mysql_free_result(result);
+  }
+
+  if (has_triggers) {
+    struct job *t = g_new0(struct job, 1);
+    struct schema_job *st = g_new0(struct schema_job, 1);
+    t->job_data = (void *)st;
+    t->type = JOB_TRIGGERS;
+    st->dbt = dbt;
+    st->filename = build_schema_table_filename(dbt->database->database_name_in_filename, dbt->table_filename, "schema-triggers");
+    g_async_queue_push(local_conf->post_data_queue, t);
   }
 }
 
@@ -233,6 +241,7 @@ struct table_job * new_table_job(struct db_table *dbt, char *partition, guint64
   tj->dbt=dbt;
   tj->st_in_file=0;
   tj->filesize=0;
+  tj->frame_filesize=0;
   tj->where=g_string_new("");
   tj->num_rows_of_last_run=0;
   update_estimated_remaining_chunks_on_dbt(tj->dbt);
@@ -240,6 +249,7 @@ struct table_job * new_table_job(struct db_table *dbt, char *partition, guint64
 }
 
 void free_table_job(struct table_job *tj){
+  wait_table_job_writes(tj);
   if (tj->sql && tj->sql->file >= 0){
     if (tj->sql->file >= 0)
       m_close(tj->td->thread_id, tj->sql->file, tj->sql->filename, tj->filesize, tj->dbt);
@@ -247,8 +257,15 @@ void free_table_job(struct table_job *tj){
     tj->sql=NULL;
   }
   if (tj->rows){
-    if (tj->rows->file >= 0)
-      m_close(tj->td->thread_id, tj->rows->file, tj->rows->filename, tj->filesize, tj->dbt);
+    if (tj->rows->file >= 0){
+      if (tj->dbt->coalesce)
+        close_bundle_segment(tj);
+      else{
+        if (zstd_frame_size > 0)
+          m_last_zstd_frame(tj->rows->filename, tj->frame_filesize);
+        m_close(tj->td->thread_id, tj->rows->file, tj->rows->filename, tj->filesize, tj->dbt);
+      }
+    }
     tj->rows->file=-1;
     tj->rows=NULL;
   }
@@ -54,6 +54,7 @@ struct dump_table_job{
   gchar *table;
   gchar *collation;
   gchar *engine;
+  guint64 data_length;
 };
 
 struct dump_database_job {
@@ -100,6 +101,8 @@ struct table_job {
   struct table_job_file *sql;
   struct table_job_file *rows;
   float filesize;
+  // --zstd-frame-size: uncompressed bytes of the current frame
+  guint64 frame_filesize;
   guint st_in_file;
 
   guint64 num_rows_of_last_run;
@@ -129,5 +132,5 @@ void create_job_to_dump_database(struct database *database);
 void create_job_to_dump_schema(struct database* database);
 void create_job_to_dump_triggers(MYSQL *conn, struct db_table *dbt);
 void create_job_to_dump_schema_triggers(struct database *database);
-void create_job_to_dump_table(gboolean is_view, gboolean is_sequence, struct database *database, gchar *table, gchar *collation, gchar *engine);
+void create_job_to_dump_table(gboolean is_view, gboolean is_sequence, struct database *database, gchar *table, gchar *collation, gchar *engine, guint64 data_length);
 void create_job_to_dump_table_list(gchar **table_list);
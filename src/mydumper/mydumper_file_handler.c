@@ -50,6 +50,39 @@ static guint dump_summary_tables=0;
 static GThread *cft[NUM_CLOSE_FILE_THREADS] = {NULL};
 static guint open_pipe=0;
 static gboolean is_pipe=FALSE;
+static GMutex *compress_threads_mutex=NULL;
+static guint compress_threads_in_use=0;
+
+// --encryption-key-file: the writer gets a pipe and an encryption thread
+// writes the encrypted content into the file
+struct encrypted_file{
+  gchar *filename;
+  int fd;
+  GThread *thread;
+};
+
+static GHashTable *encrypted_files=NULL;
+static GMutex *encrypted_files_mutex=NULL;
+
+// --zstd-dictionary: the files opened before the dictionary exists are
+// written uncompressed. When enough of them were closed, they are used to
+// train the dictionary and then they are compressed with it, like every
+// file opened afterwards. If the training fails, no file uses a
+// dictionary, so myloader always knows how to decompress the dump.
+struct dictionary_file{
+  gchar *filename;
+  struct db_table *dbt;
+  guint64 size;
+};
+
+static GMutex *zstd_dictionary_mutex=NULL;
+static GHashTable *zstd_dictionary_open_files=NULL;
+static GList *zstd_dictionary_closed_files=NULL;
+static guint zstd_dictionary_closed_count=0;
+static gboolean zstd_dictionary_training=FALSE;
+static gboolean zstd_dictionary_ready=FALSE;
+static gchar *zstd_dictionary=NULL;
+static gchar **zstd_dictionary_cmd=NULL;
 
 static void ensure_dump_summary_mutex(void){
   if (dump_summary_mutex == NULL){
@@ -173,9 +206,52 @@ guint dump_summary_get_tables(void){
   return tables_count;
 }
 
+// Returns the write end of a pipe whose content is encrypted into fd
+static
+int start_encrypted_file(gchar *filename, int fd){
+  int p[2];
+  if (pipe(p))
+    m_critical("Not able to create pipe to encrypt %s (%d)", filename, errno);
+  fcntl(p[0], F_SETFD, FD_CLOEXEC);
+  fcntl(p[1], F_SETFD, FD_CLOEXEC);
+  struct encrypted_file *ef=g_new0(struct encrypted_file, 1);
+  ef->filename=g_strdup_printf("%s%s", filename, ENCRYPTION_EXTENSION);
+  ef->fd=fd;
+  ef->thread=start_encryption(p[0], fd, ef->filename);
+  g_mutex_lock(encrypted_files_mutex);
+  g_hash_table_insert(encrypted_files, g_strdup(filename), ef);
+  g_mutex_unlock(encrypted_files_mutex);
+  return p[1];
+}
+
+// The write end must be closed already. Returns the name of the encrypted file
+static
+gchar *finish_encrypted_file(gchar *filename){
+  g_mutex_lock(encrypted_files_mutex);
+  struct encrypted_file *ef=g_hash_table_lookup(encrypted_files, filename);
+  g_hash_table_remove(encrypted_files, filename);
+  g_mutex_unlock(encrypted_files_mutex);
+  if (!ef)
+    m_critical("Encrypted file %s not found", filename);
+  g_thread_join(ef->thread);
+  close(ef->fd);
+  gchar *encrypted_filename=ef->filename;
+  g_free(ef);
+  return encrypted_filename;
+}
+
 // FILE open/close without pipe
 int m_open_file(char **filename, const char *type ){
   (void) type;
+  if (encryption_key_file){
+    gchar *encrypted_filename=g_strdup_printf("%s%s", *filename, ENCRYPTION_EXTENSION);
+    int fd=open(encrypted_filename, O_CREAT|O_WRONLY|O_TRUNC, 0660 );
+    if (fd<0)
+      m_critical("Couldn't open file(%s): %s", encrypted_filename, strerror(errno));
+    g_free(encrypted_filename);
+    dump_summary_note_file_created();
+    return start_encrypted_file(*filename, fd);
+  }
   int fd=open(*filename, O_CREAT|O_WRONLY|O_TRUNC, 0660 );
   if (fd<0)
     m_critical("Couldn't open file(%s): %s", *filename, strerror(errno));
@@ -185,9 +261,14 @@ int m_open_file(char **filename, const char *type ){
 }
 
 int m_close_file(guint thread_id, int file, gchar *filename, guint64 size, struct db_table * dbt){
+  gchar *encrypted_filename=NULL;
   if (file >= 0){
     trace("Thread %d: Closing file(%d): %s of size: %"G_GUINT64_FORMAT, thread_id, file, filename, size);
     int r=close(file);
+    if (encryption_key_file){
+      encrypted_filename=finish_encrypted_file(filename);
+      filename=encrypted_filename;
+    }
     if (size > 0){
       if (exec_command)  exec_queue_push(dbt, g_strdup(filename));
       else if (stream) stream_queue_push(dbt, g_strdup(filename));
@@ -200,11 +281,13 @@ int m_close_file(guint thread_id, int file, gchar *filename, guint64 size, struc
           g_debug("Thread %d: File removed: %s", thread_id, filename);
         }
       }
+      g_free(encrypted_filename);
       return r;
     }
   }else{
     m_critical("Trying to close %s with fd: %d", filename, file); 
   }
+  g_free(encrypted_filename);
   return 0;
 }
 
@@ -240,7 +323,7 @@ void release_pid(){
   g_async_queue_push(available_pids, GINT_TO_POINTER(1));
 }
 
-int execute_file_per_thread( int p_in[2], int out){
+int execute_file_per_thread( int p_in[2], int out, gchar **cmd){
   int childpid=fork();
   if(!childpid){
     dup2(p_in[0], STDIN_FILENO);
@@ -249,19 +332,223 @@ int execute_file_per_thread( int p_in[2], int out){
     close(out);
     int fd=3;
     for (fd=3; fd<256; fd++) (void) close(fd);
-    execv(exec_per_thread_cmd[0],exec_per_thread_cmd);
+    execv(cmd[0],cmd);
   }
   return childpid;
 }
 
+// --compress-threads: the workers are split between the open files when the
+// compressor starts, and returned when it ends. A file opened when few others
+// are open, or a new --zstd-frame-size frame, gets more of them.
+static
+int start_compressor(struct fifo *f, gchar **cmd){
+  int out=f->encryption ? f->fdencrypt : f->fdout;
+  if (compress_threads == 0)
+    return execute_file_per_thread(f->pipe, out, cmd);
+  g_mutex_lock(compress_threads_mutex);
+  guint open_files=g_atomic_int_get(&open_pipe);
+  guint share=compress_threads / (open_files > 0 ? open_files : 1);
+  guint available=compress_threads > compress_threads_in_use ? compress_threads - compress_threads_in_use : 0;
+  f->compress_threads=MAX(1, MIN(share, available));
+  compress_threads_in_use+=f->compress_threads;
+  g_mutex_unlock(compress_threads_mutex);
+
+  guint n=g_strv_length(cmd);
+  gchar **threaded_cmd=g_new0(gchar *, n + 2);
+  memcpy(threaded_cmd, cmd, n * sizeof(gchar *));
+  threaded_cmd[n]=g_strdup_printf("-T%u", f->compress_threads);
+  trace("Compressing %s with %u threads", f->stdout_filename, f->compress_threads);
+  int childpid=execute_file_per_thread(f->pipe, out, threaded_cmd);
+  g_free(threaded_cmd[n]);
+  g_free(threaded_cmd);
+  return childpid;
+}
+
+static
+void release_compress_threads(struct fifo *f){
+  if (f->compress_threads == 0)
+    return;
+  g_mutex_lock(compress_threads_mutex);
+  compress_threads_in_use-=f->compress_threads;
+  g_mutex_unlock(compress_threads_mutex);
+  f->compress_threads=0;
+}
+
+// zstd dictionary
+
+static
+gboolean run_zstd(gchar **argv){
+  gint status=0;
+  GError *error=NULL;
+  if (!g_spawn_sync(NULL, argv, NULL, G_SPAWN_STDOUT_TO_DEV_NULL, NULL, NULL, NULL, NULL, &status, &error)){
+    g_warning("Failed to execute %s: %s", argv[0], error->message);
+    g_error_free(error);
+    return FALSE;
+  }
+  return g_spawn_check_exit_status(status, NULL);
+}
+
+static
+void compress_with_zstd_dictionary(struct dictionary_file *df){
+  gchar *compressed=g_strdup_printf("%s%s", df->filename, exec_per_thread_extension);
+  GPtrArray *argv=g_ptr_array_new();
+  g_ptr_array_add(argv, exec_per_thread_cmd[0]);
+  g_ptr_array_add(argv, (gchar *)"-q");
+  g_ptr_array_add(argv, (gchar *)"-f");
+  g_ptr_array_add(argv, (gchar *)"--rm");
+  if (zstd_dictionary){
+    g_ptr_array_add(argv, (gchar *)"-D");
+    g_ptr_array_add(argv, zstd_dictionary);
+  }
+  g_ptr_array_add(argv, (gchar *)"-o");
+  g_ptr_array_add(argv, compressed);
+  g_ptr_array_add(argv, df->filename);
+  g_ptr_array_add(argv, NULL);
+  if (!run_zstd((gchar **)argv->pdata))
+    m_critical("Failed to compress %s", df->filename);
+  g_ptr_array_free(argv, TRUE);
+  if (df->size > 0 && stream)
+    stream_queue_push(df->dbt, compressed);
+  else
+    g_free(compressed);
+  g_free(df->filename);
+  g_free(df);
+}
+
+static
+void train_zstd_dictionary(){
+  gchar *dictionary=g_build_filename(dump_directory, ZSTD_DICTIONARY_FILENAME, NULL);
+  GPtrArray *argv=g_ptr_array_new();
+  GList *l=NULL;
+  gboolean trained=FALSE;
+  g_ptr_array_add(argv, exec_per_thread_cmd[0]);
+  g_ptr_array_add(argv, (gchar *)"--train");
+  g_ptr_array_add(argv, (gchar *)"-q");
+  g_ptr_array_add(argv, (gchar *)"-o");
+  g_ptr_array_add(argv, dictionary);
+  // The files stay on the list until the dictionary is ready
+  g_mutex_lock(zstd_dictionary_mutex);
+  for (l=zstd_dictionary_closed_files; l; l=l->next)
+    g_ptr_array_add(argv, ((struct dictionary_file *)l->data)->filename);
+  guint samples=zstd_dictionary_closed_count;
+  g_mutex_unlock(zstd_dictionary_mutex);
+  g_ptr_array_add(argv, NULL);
+
+  if (samples > 0){
+    g_message("Training zstd dictionary with %u files", samples);
+    trained=run_zstd((gchar **)argv->pdata);
+  }
+  g_ptr_array_free(argv, TRUE);
+
+  if (trained){
+    guint n=g_strv_length(exec_per_thread_cmd);
+    zstd_dictionary_cmd=g_new0(gchar *, n + 3);
+    memcpy(zstd_dictionary_cmd, exec_per_thread_cmd, n * sizeof(gchar *));
+    zstd_dictionary_cmd[n]=(gchar *)"-D";
+    zstd_dictionary_cmd[n+1]=dictionary;
+    zstd_dictionary=dictionary;
+    if (stream)
+      stream_queue_push(NULL, g_strdup(dictionary));
+  }else{
+    if (samples > 0){
+      g_warning("Not possible to train the zstd dictionary, files are going to be compressed without it");
+      remove(dictionary);
+    }
+    g_free(dictionary);
+  }
+
+  g_mutex_lock(zstd_dictionary_mutex);
+  zstd_dictionary_ready=TRUE;
+  GList *closed_files=zstd_dictionary_closed_files;
+  zstd_dictionary_closed_files=NULL;
+  g_mutex_unlock(zstd_dictionary_mutex);
+  closed_files=g_list_reverse(closed_files);
+  for (l=closed_files; l; l=l->next)
+    compress_with_zstd_dictionary(l->data);
+  g_list_free(closed_files);
+}
+
+static
+int open_file_for_zstd_dictionary(gchar **filename, const char *type){
+  g_mutex_lock(zstd_dictionary_mutex);
+  if (zstd_dictionary_ready){
+    g_mutex_unlock(zstd_dictionary_mutex);
+    return -1;
+  }
+  struct dictionary_file *df=g_new0(struct dictionary_file, 1);
+  df->filename=g_strdup(*filename);
+  g_hash_table_insert(zstd_dictionary_open_files, df->filename, df);
+  g_mutex_unlock(zstd_dictionary_mutex);
+  return m_open_file(filename, type);
+}
+
+static
+gboolean close_file_for_zstd_dictionary(guint thread_id, int file, gchar *filename, guint64 size, struct db_table * dbt){
+  g_mutex_lock(zstd_dictionary_mutex);
+  struct dictionary_file *df=g_hash_table_lookup(zstd_dictionary_open_files, filename);
+  if (df)
+    g_hash_table_remove(zstd_dictionary_open_files, filename);
+  g_mutex_unlock(zstd_dictionary_mutex);
+  if (!df)
+    return FALSE;
+
+  trace("Thread %d: Closing file(%d): %s of size: %"G_GUINT64_FORMAT, thread_id, file, filename, size);
+  close(file);
+  if (size == 0 && !build_empty_files){
+    if (remove(df->filename)) {
+      g_warning("Thread %d: Failed to remove empty file : %s", thread_id, df->filename);
+    }else{
+      dump_summary_note_file_removed();
+      g_debug("Thread %d: File removed: %s", thread_id, df->filename);
+    }
+    g_free(df->filename);
+    g_free(df);
+    return TRUE;
+  }
+  df->dbt=dbt;
+  df->size=size;
+
+  g_mutex_lock(zstd_dictionary_mutex);
+  if (zstd_dictionary_ready){
+    g_mutex_unlock(zstd_dictionary_mutex);
+    compress_with_zstd_dictionary(df);
+    return TRUE;
+  }
+  zstd_dictionary_closed_files=g_list_prepend(zstd_dictionary_closed_files, df);
+  zstd_dictionary_closed_count++;
+  gboolean train=!zstd_dictionary_training && zstd_dictionary_closed_count >= zstd_dictionary_samples;
+  if (train)
+    zstd_dictionary_training=TRUE;
+  g_mutex_unlock(zstd_dictionary_mutex);
+  if (train)
+    train_zstd_dictionary();
+  return TRUE;
+}
+
+// Dumps with less files than --zstd-dictionary train it at the end
+static
+void finish_zstd_dictionary(){
+  g_mutex_lock(zstd_dictionary_mutex);
+  gboolean train=!zstd_dictionary_training;
+  zstd_dictionary_training=TRUE;
+  g_mutex_unlock(zstd_dictionary_mutex);
+  if (train)
+    train_zstd_dictionary();
+}
+
 // PIPE open/close
 
 // filename must never use the compression extension. .fifo files should be deprecated
 int m_open_pipe(gchar **filename, const char *type){
   (void)type;
+  if (zstd_dictionary_samples > 0){
+    int fd=open_file_for_zstd_dictionary(filename, type);
+    if (fd >= 0)
+      return fd;
+  }
   g_atomic_int_inc(&open_pipe);
 
-  gchar *new_filename = g_strdup_printf("%s%s", *filename, exec_per_thread_extension);
+  gchar *new_filename = g_strdup_printf("%s%s%s", *filename, exec_per_thread_extension, encryption_key_file ? ENCRYPTION_EXTENSION : "");
   (void)type;
   struct fifo *f=NULL;
 
@@ -289,10 +576,24 @@ int m_open_pipe(gchar **filename, const char *type){
   if (status != 0){
     g_error("Not able to create pipe (%d)", e);
   }
+  // The compressor writes into a pipe and the encryption thread into the file
+  int encryption_pipe[2];
+  if (encryption_key_file){
+    if (pipe(encryption_pipe))
+      g_error("Not able to create pipe to encrypt %s (%d)", new_filename, errno);
+    fcntl(encryption_pipe[0], F_SETFD, FD_CLOEXEC);
+    fcntl(encryption_pipe[1], F_SETFD, FD_CLOEXEC);
+    f->fdencrypt=encryption_pipe[1];
+    f->encryption=start_encryption(encryption_pipe[0], f->fdout, new_filename);
+  }
   
-  f->child_pid=execute_file_per_thread(f->pipe, f->fdout);
+  f->child_pid=start_compressor(f, zstd_dictionary_cmd ? zstd_dictionary_cmd : exec_per_thread_cmd);
+  if (f->encryption)
+    close(f->fdencrypt);
 
   g_mutex_unlock(pipe_creation);
+  if (zstd_frame_size > 0)
+    f->zstd_frames=g_array_new(FALSE, FALSE, sizeof(struct zstd_frame));
   g_mutex_lock(fifo_table_mutex);
   g_hash_table_insert(fifo_hash,f->filename,f);
   g_mutex_unlock(fifo_table_mutex);
@@ -300,6 +601,8 @@ int m_open_pipe(gchar **filename, const char *type){
 }
 
 int m_close_pipe(guint thread_id, int file, gchar *filename, guint64 size, struct db_table * dbt){
+  if (zstd_dictionary_samples > 0 && close_file_for_zstd_dictionary(thread_id, file, filename, size, dbt))
+    return 0;
   release_pid();
   g_mutex_lock(fifo_table_mutex);
   trace("Thread %d: Closing pipe(%d): %s of size: %"G_GUINT64_FORMAT, thread_id, file, filename, size);
@@ -316,6 +619,87 @@ int m_close_pipe(guint thread_id, int file, gchar *filename, guint64 size, struc
   return 1;
 }
 
+// --zstd-frame-size: a new zstd process is started on the same output file
+// for each frame. Concatenated frames are still a valid zstd file, and the
+// seek table at the end tells myloader where each frame starts.
+
+static
+struct fifo *get_fifo(gchar *filename){
+  g_mutex_lock(fifo_table_mutex);
+  struct fifo *f=g_hash_table_lookup(fifo_hash,filename);
+  g_mutex_unlock(fifo_table_mutex);
+  return f;
+}
+
+static
+void add_zstd_frame(struct fifo *f, guint64 frame_size){
+  guint64 end=lseek(f->fdout, 0, SEEK_END);
+  struct zstd_frame frame={ end - f->zstd_frame_offset, frame_size };
+  g_array_append_val(f->zstd_frames, frame);
+  f->zstd_frame_offset=end;
+}
+
+// frame_size is the uncompressed size of the frame that is ending
+int m_next_zstd_frame(int file, gchar *filename, guint64 frame_size){
+  struct fifo *f=get_fifo(filename);
+  if (f == NULL || f->zstd_frames == NULL || f->pipe[1] != file)
+    return file;
+  int status=0;
+  g_mutex_lock(pipe_creation);
+  close(f->pipe[1]);
+  close(f->pipe[0]);
+  g_mutex_unlock(pipe_creation);
+  if (waitpid(f->child_pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    m_critical("Compression of %s failed", f->stdout_filename);
+  release_compress_threads(f);
+  add_zstd_frame(f, frame_size);
+  trace("New zstd frame on %s at %"G_GUINT64_FORMAT, f->stdout_filename, f->zstd_frame_offset);
+  g_mutex_lock(pipe_creation);
+  if (pipe(f->pipe) != 0)
+    m_critical("Not able to create pipe for %s (%d)", f->stdout_filename, errno);
+  f->child_pid=start_compressor(f, exec_per_thread_cmd);
+  g_mutex_unlock(pipe_creation);
+  return f->pipe[1];
+}
+
+void m_last_zstd_frame(gchar *filename, guint64 frame_size){
+  struct fifo *f=get_fifo(filename);
+  if (f != NULL)
+    f->zstd_last_frame_size=frame_size;
+}
+
+static
+void append_le32(GByteArray *buffer, guint32 value){
+  guint32 le=GUINT32_TO_LE(value);
+  g_byte_array_append(buffer, (guint8 *)&le, sizeof(le));
+}
+
+// Files that never started a second frame are left as plain zstd files
+static
+void write_zstd_seek_table(struct fifo *f){
+  if (f->zstd_frames->len > 0){
+    add_zstd_frame(f, f->zstd_last_frame_size);
+    GByteArray *table=g_byte_array_new();
+    guint i;
+    append_le32(table, ZSTD_SKIPPABLE_MAGIC);
+    append_le32(table, f->zstd_frames->len * 8 + ZSTD_SEEK_TABLE_FOOTER_SIZE);
+    for (i=0; i < f->zstd_frames->len; i++){
+      append_le32(table, g_array_index(f->zstd_frames, struct zstd_frame, i).compressed_size);
+      append_le32(table, g_array_index(f->zstd_frames, struct zstd_frame, i).decompressed_size);
+    }
+    append_le32(table, f->zstd_frames->len);
+    // Seek table descriptor: no checksums
+    guint8 descriptor=0;
+    g_byte_array_append(table, &descriptor, 1);
+    append_le32(table, ZSTD_SEEKABLE_MAGIC);
+    if (write(f->fdout, table->data, table->len) != (ssize_t)table->len)
+      g_error("while writing the seek table of %s (%d)", f->stdout_filename, errno);
+    g_byte_array_free(table, TRUE);
+  }
+  g_array_free(f->zstd_frames, TRUE);
+  f->zstd_frames=NULL;
+}
+
 // close_file_thread
 
 void final_step_close_file(guint thread_id, gchar *filename, struct fifo *f, float size, struct db_table * dbt) {
@@ -346,6 +730,11 @@ void * close_file_thread(void *data){
     if (f->error_number==EAGAIN){
       usleep(1000);
     }
+    release_compress_threads(f);
+    if (f->encryption)
+      g_thread_join(f->encryption);
+    if (f->zstd_frames)
+      write_zstd_seek_table(f);
     if (fsync(f->fdout))
       g_error("while syncing file %s (%d)",f->filename, errno);
     close(f->fdout);
@@ -358,6 +747,8 @@ void * close_file_thread(void *data){
 }
 
 void wait_close_files(){
+  if (zstd_dictionary_samples > 0)
+    finish_zstd_dictionary();
   if (is_pipe){
     // Send shutdown signal to all close_file_threads
     guint i;
@@ -383,6 +774,10 @@ void set_pipe_backup(){
 
 void initialize_file_handler(){
   reset_dump_summary();
+  if (encryption_key_file){
+    encrypted_files=g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    encrypted_files_mutex=g_mutex_new();
+  }
   if (!is_pipe){
     m_open  = &m_open_file;
     m_close = &m_close_file;
@@ -396,8 +791,13 @@ void initialize_file_handler(){
       release_pid();
     }
     pipe_creation = g_mutex_new();
+    compress_threads_mutex = g_mutex_new();
     fifo_hash=g_hash_table_new(g_str_hash, g_str_equal);
     fifo_table_mutex = g_mutex_new();
+    if (zstd_dictionary_samples > 0){
+      zstd_dictionary_mutex=g_mutex_new();
+      zstd_dictionary_open_files=g_hash_table_new(g_str_hash, g_str_equal);
+    }
 
     // Create multiple close_file_threads for parallel fsync
     gchar thread_name[32];
@@ -41,11 +41,27 @@ struct fifo{
   int pipe[2];
   GMutex *out_mutex;
   int error_number;
+  // --zstd-frame-size
+  GArray *zstd_frames;
+  guint64 zstd_frame_offset;
+  guint64 zstd_last_frame_size;
+  // --compress-threads lent to the compressor
+  guint compress_threads;
+  // --encryption-key-file: the compressor writes into fdencrypt
+  int fdencrypt;
+  GThread *encryption;
+};
+
+struct zstd_frame{
+  guint32 compressed_size;
+  guint32 decompressed_size;
 };
 
 void set_pipe_backup();
 void initialize_file_handler();
 int m_open_pipe(char **filename, const char *type);
+int m_next_zstd_frame(int file, gchar *filename, guint64 frame_size);
+void m_last_zstd_frame(gchar *filename, guint64 frame_size);
 void release_pid();
 void child_process_ended(int child_pid);
 void wait_close_files();
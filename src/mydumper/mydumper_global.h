@@ -21,6 +21,8 @@ extern gchar *fields_terminated_by_ld;
 extern gboolean csv;
 extern gboolean clickhouse;
 extern gboolean include_header;
+extern gboolean server_outfile;
+extern gchar *secure_file_priv;
 extern gboolean replace;
 extern guint chunk_filesize;
 extern gchar *ignore_engines_str;
@@ -122,6 +124,11 @@ extern gboolean it_is_a_consistent_backup;
 extern gchar *partition_regex;
 extern gchar **exec_per_thread_cmd;
 extern const gchar *compress_method;
+extern guint zstd_dictionary_samples;
+extern guint zstd_frame_size;
+extern guint compress_threads;
+extern guint coalesce_tables;
+extern guint transportable_tablespace_size;
 extern guint64 min_chunk_step_size;
 extern guint64 max_chunk_step_size;
 extern gboolean compact;
@@ -135,6 +142,9 @@ extern enum output_format output_format;
 extern struct function_pointer identity_function_pointer;
 extern GAsyncQueue *stream_queue;
 extern gboolean masquerade_filename;
+extern gboolean async_write;
+extern guint max_memory;
+extern gchar *masquerade_key;
 extern enum sync_thread_lock_mode sync_thread_lock_mode;
 extern guint trx_tables;
 extern gboolean replica_stopped;
@@ -372,7 +372,7 @@ struct chunk_step_item *get_next_integer_chunk(struct db_table *dbt){
 
           if (new_csi_next){
             trace("Multicolumn table is splittable");
-            new_csi_next->multicolumn=FALSE;
+            new_csi_next->multicolumn=csi->next->multicolumn;
             csi->deep=csi->deep+1;
             new_csi=clone_chunk_step_item(csi);
             new_csi->status=ASSIGNED;
@@ -689,7 +689,7 @@ retry:
       if (rows > tj->dbt->min_chunk_step_size){
         csi->next = initialize_chunk_step_item(td->thrconn, tj->dbt, csi->position + 1, rows, csi->where);
         if (csi->next){
-          csi->next->multicolumn=FALSE;
+          csi->next->multicolumn= can_go_deeper_on_chunk_step_item(tj->dbt, csi->next);
           trace("Thread %d: I-Chunk 2: New next with where %s | rows: %lld", td->thread_id, csi->where->str, rows);
         }
       }else{
@@ -753,7 +753,7 @@ trace("Thread %d: I-Chunk 2-3: step %lld ", td->thread_id, cs->integer_step.step
     trace("Thread %d: I-Chunk 4: going down", td->thread_id);
     // Multi column
     if (csi->next->needs_refresh)
-      if (!refresh_integer_min_max(td->thrconn, tj->dbt, csi->next)){
+      if (!refresh_chunk_step_item(td->thrconn, tj->dbt, csi->next)){
         trace("Thread %d: I-Chunk 4: No min and max found", td->thread_id);
         goto update_min;
       }
@@ -869,7 +869,7 @@ end_process:
     csi->multicolumn=tj->dbt->multicolumn;
 
   if (csi->next!=NULL){
-    free_integer_step_item(csi->next);
+    csi->next->chunk_functions.free(csi->next);
     csi->next=NULL;
   }
   g_mutex_unlock(csi->mutex);
@@ -1018,3 +1018,163 @@ void determine_if_we_can_go_deeper( struct chunk_step_item * csi, guint64 rows){
       csi->multicolumn=FALSE;
   }
 }
+
+// Histogram in information_schema.COLUMN_STATISTICS is a JSON document where
+// the buckets are [value, cumulative_frequency] on singleton histograms and
+// [lower, upper, cumulative_frequency, num_distinct] on equi-height ones
+struct histogram_bucket {
+  gdouble lower;
+  gdouble upper;
+  gdouble cumulative_frequency;
+};
+
+static
+const gchar *skip_histogram_separators(const gchar *p){
+  while (*p==' ' || *p==',')
+    p++;
+  return p;
+}
+
+static
+GArray *parse_histogram_buckets(const gchar *histogram){
+  gboolean equi_height=g_strstr_len(histogram, -1, "\"equi-height\"")!=NULL;
+  const gchar *p=g_strstr_len(histogram, -1, "\"buckets\"");
+  if (!p || !(p=strchr(p, '[')))
+    return NULL;
+  p=skip_histogram_separators(p+1);
+  GArray *buckets=g_array_new(FALSE, FALSE, sizeof(struct histogram_bucket));
+  struct histogram_bucket b;
+  gchar *end=NULL;
+  while (*p=='['){
+    // Values that are not numbers are base64 encoded, we can not use them
+    b.lower=g_ascii_strtod(p+1, &end);
+    if (end==p+1)
+      goto fail;
+    p=skip_histogram_separators(end);
+    if (equi_height){
+      b.upper=g_ascii_strtod(p, &end);
+      if (end==p)
+        goto fail;
+      p=skip_histogram_separators(end);
+    }else
+      b.upper=b.lower;
+    b.cumulative_frequency=g_ascii_strtod(p, &end);
+    if (end==p || !(p=strchr(end, ']')))
+      goto fail;
+    g_array_append_val(buckets, b);
+    p=skip_histogram_separators(p+1);
+  }
+  if (buckets->len>0)
+    return buckets;
+fail:
+  g_array_free(buckets, TRUE);
+  return NULL;
+}
+
+// Returns parts-1 ascending values that split the column in parts with the
+// same amount of rows, interpolating inside the equi-height buckets
+static
+GArray *get_integer_boundaries_from_histogram(MYSQL *conn, struct db_table *dbt, gchar *field, guint parts){
+  if (!server_support_column_statistics())
+    return NULL;
+  gchar *escaped_field=escape_string(conn, field);
+  gchar *query=g_strdup_printf("SELECT HISTOGRAM FROM information_schema.COLUMN_STATISTICS WHERE SCHEMA_NAME='%s' AND TABLE_NAME='%s' AND COLUMN_NAME='%s'",
+                        dbt->database->source_database_escaped, dbt->escaped_table, escaped_field);
+  MYSQL_RES *res=m_store_result(conn, query, NULL, NULL);
+  g_free(query);
+  g_free(escaped_field);
+  if (!res)
+    return NULL;
+  MYSQL_ROW row=mysql_fetch_row(res);
+  GArray *buckets= row && row[0] ? parse_histogram_buckets(row[0]) : NULL;
+  mysql_free_result(res);
+  if (!buckets)
+    return NULL;
+
+  GArray *boundaries=g_array_new(FALSE, FALSE, sizeof(gdouble));
+  // Last cumulative frequency does not include the NULL values
+  gdouble total=g_array_index(buckets, struct histogram_bucket, buckets->len-1).cumulative_frequency, previous=0, value;
+  guint i=0, k;
+  struct histogram_bucket *b;
+  for (k=1; k<parts; k++){
+    gdouble target=total*k/parts;
+    while (i<buckets->len-1 && g_array_index(buckets, struct histogram_bucket, i).cumulative_frequency < target){
+      previous=g_array_index(buckets, struct histogram_bucket, i).cumulative_frequency;
+      i++;
+    }
+    b=&g_array_index(buckets, struct histogram_bucket, i);
+    value= b->cumulative_frequency > previous ?
+             b->lower + (b->upper - b->lower) * (target - previous) / (b->cumulative_frequency - previous):
+             b->upper;
+    value=ceil(value);
+    if (boundaries->len==0 || value > g_array_index(boundaries, gdouble, boundaries->len-1))
+      g_array_append_val(boundaries, value);
+  }
+  g_array_free(buckets, TRUE);
+  return boundaries;
+}
+
+// Builds the first level of chunks of an integer primary key at the quantiles
+// of its histogram. The first chunk is returned and the rest are pushed to
+// chunks_queue; each of them keeps splitting itself as any other integer chunk
+struct chunk_step_item *new_histogram_integer_step_items(MYSQL *conn, struct db_table *dbt, GString *prefix, gchar *field, gboolean is_unsigned, union type type, guint64 rows, guint64 step){
+  guint parts= dbt->max_chunk_step_size!=0 ? rows / dbt->max_chunk_step_size : 0;
+  if (parts < dbt->max_threads_per_table)
+    parts=dbt->max_threads_per_table;
+  if (parts > MAX_HISTOGRAM_PARTS)
+    parts=MAX_HISTOGRAM_PARTS;
+  if (parts < 2)
+    return NULL;
+  GArray *boundaries=get_integer_boundaries_from_histogram(conn, dbt, field, parts);
+  if (!boundaries)
+    return NULL;
+
+  // The histogram could be outdated, we only use the values inside min and max
+  GArray *starts=g_array_new(FALSE, FALSE, sizeof(union type));
+  union type t=type;
+  guint i;
+  for (i=0; i<boundaries->len; i++){
+    gdouble value=g_array_index(boundaries, gdouble, i);
+    if (is_unsigned){
+      if (value <= 0 || value <= (gdouble)t.unsign.min || value > (gdouble)type.unsign.max)
+        continue;
+      t.unsign.max=(guint64)value - 1;
+      g_array_append_val(starts, t);
+      t.unsign.min=(guint64)value;
+    }else{
+      if (value <= (gdouble)t.sign.min || value > (gdouble)type.sign.max)
+        continue;
+      t.sign.max=(gint64)value - 1;
+      g_array_append_val(starts, t);
+      t.sign.min=(gint64)value;
+    }
+  }
+  g_array_free(boundaries, TRUE);
+  if (starts->len == 0){
+    g_array_free(starts, TRUE);
+    return NULL;
+  }
+  if (is_unsigned)
+    t.unsign.max=type.unsign.max;
+  else
+    t.sign.max=type.sign.max;
+  g_array_append_val(starts, t);
+
+  g_message("`%s`.`%s` will be split in %u chunks based on the histogram of `%s`", dbt->database->source_database, dbt->table, starts->len, field);
+  // Parts and deep follow the same tree that split_chunk_step() builds, so the
+  // chunks created later on do not reuse a part number
+  guint deep=0;
+  while ((1u << deep) < starts->len)
+    deep++;
+  struct chunk_step_item *first=NULL, *csi=NULL;
+  for (i=0; i<starts->len; i++){
+    csi=new_integer_step_item(i==0, prefix, field, is_unsigned, g_array_index(starts, union type, i), deep, FALSE, step, dbt->min_chunk_step_size, dbt->max_chunk_step_size, i, i>0, i>0, NULL, 0, dbt->multicolumn, 0);
+    if (first){
+      dbt->chunks=g_list_prepend(dbt->chunks, csi);
+      g_async_queue_push(dbt->chunks_queue, csi);
+    }else
+      first=csi;
+  }
+  g_array_free(starts, TRUE);
+  return first;
+}
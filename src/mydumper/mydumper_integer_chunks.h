@@ -23,6 +23,8 @@
 
 #include "mydumper_chunks.h"
 
+#define MAX_HISTOGRAM_PARTS 1024
+
 struct unsigned_int{
   guint64 min;
   guint64 cursor;
@@ -60,4 +62,6 @@ void free_integer_step(union chunk_step * cs);
 struct chunk_step_item *get_next_integer_chunk(struct db_table *dbt);
 void process_integer_chunk(struct table_job *tj, struct chunk_step_item *csi);
 gchar * get_integer_chunk_where(union chunk_step * chunk_step);
+gboolean refresh_integer_min_max(MYSQL *conn, struct db_table *dbt, struct chunk_step_item *csi);
 void update_integer_where_on_gstring(GString *where, gboolean include_null, GString *prefix, gchar * field, gboolean is_unsigned, union type type, gboolean use_cursor);
+struct chunk_step_item *new_histogram_integer_step_items(MYSQL *conn, struct db_table *dbt, GString *prefix, gchar *field, gboolean is_unsigned, union type type, guint64 rows, guint64 step);
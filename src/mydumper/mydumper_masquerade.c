@@ -24,14 +24,25 @@
 #include "mydumper_masquerade.h"
 #include "mydumper_common.h"
 #include "mydumper.h"
+#include "mydumper_global.h"
 struct function_pointer identity_function_pointer = {&identity_function, FALSE, NULL, NULL, NULL, NULL, FALSE, 0, 0, NULL, FALSE};
 
 GHashTable *file_hash = NULL;
+static GHmac *masquerade_hmac = NULL;
 
 void initialize_masquerade(){
   srand(clock());
 
   file_hash = g_hash_table_new_full( g_str_hash, g_str_equal,  &g_free, &g_free );
+
+  guint8 random_key[32];
+  guint i;
+  if (masquerade_key == NULL){
+    for (i=0; i<sizeof(random_key); i++)
+      random_key[i]=(guint8) g_random_int_range(0, 256);
+    masquerade_hmac=g_hmac_new(G_CHECKSUM_SHA256, random_key, sizeof(random_key));
+  }else
+    masquerade_hmac=g_hmac_new(G_CHECKSUM_SHA256, (const guchar *)masquerade_key, strlen(masquerade_key));
 }
 
 void finalize_masquerade(){
@@ -92,54 +103,76 @@ gboolean identity_function(GString *str, gchar * row, gulong* length,  struct fu
   return TRUE;
 }
 
+static
+struct masquerade_shard *new_masquerade_shards(GDestroyNotify value_destroy_func){
+  struct masquerade_shard *shards=g_new0(struct masquerade_shard, MASQUERADE_SHARDS);
+  guint i;
+  for (i=0; i<MASQUERADE_SHARDS; i++){
+    g_mutex_init(&(shards[i].mutex));
+    shards[i].table=g_hash_table_new_full(g_str_hash, g_str_equal, g_free, value_destroy_func);
+  }
+  return shards;
+}
+
+static inline
+struct masquerade_shard *get_masquerade_shard(struct masquerade_shard *shards, const gchar *key){
+  return &(shards[g_str_hash(key) % MASQUERADE_SHARDS]);
+}
+
+static
+gboolean add_unique_value(struct function_pointer *fp, const gchar *value){
+  struct masquerade_shard *shard=get_masquerade_shard(fp->unique_set, value);
+  gboolean added=FALSE;
+  g_mutex_lock(&(shard->mutex));
+  if (!g_hash_table_contains(shard->table, value)){
+    g_hash_table_add(shard->table, g_strdup(value));
+    added=TRUE;
+  }
+  g_mutex_unlock(&(shard->mutex));
+  return added;
+}
+
 gboolean random_basic_function(GString *str, gchar *row, gulong* length, struct function_pointer *fp, void (*random_funtion)(gchar *, guint) ){
 
   gchar *new_r=NULL;
   guint max_length=0;
-  if (fp && fp->memory && row){
-    new_r=g_hash_table_lookup(fp->memory, row);
-    if (new_r){
-      *length=strlen(new_r);
-      g_string_assign(str,new_r);
-      return TRUE;
-    }
-  }
-  gchar*_key=NULL;
+  struct masquerade_shard *memory_shard=NULL;
 
   if (row){
-    if (fp && fp->memory)
-      _key=g_strdup(row);
-
-retry:
-    max_length=fp->max_length>0 && *length>fp->max_length?fp->max_length:*length;
-    g_string_set_size(str, max_length);
-    random_funtion(str->str, max_length);
-
-    if (fp && fp->unique){
-      if (g_list_find_custom(fp->unique_list,str->str,(GCompareFunc)g_strcmp0)){
-        goto retry;
+    if (fp && fp->memory){
+      // The shard stays locked until the new value is stored, so the same
+      // row gets the same value even when two threads find it at once
+      memory_shard=get_masquerade_shard(fp->memory, row);
+      g_mutex_lock(&(memory_shard->mutex));
+      new_r=g_hash_table_lookup(memory_shard->table, row);
+      if (new_r){
+        g_string_assign(str,new_r);
+        g_mutex_unlock(&(memory_shard->mutex));
+        *length=str->len;
+        return TRUE;
       }
-      fp->unique_list=g_list_prepend(fp->unique_list,g_strdup(str->str));
     }
 
-    if (fp && fp->memory)
-      g_hash_table_insert(fp->memory,_key,g_strdup(str->str));
+    max_length=fp->max_length>0 && *length>fp->max_length?fp->max_length:*length;
+    do{
+      g_string_set_size(str, max_length);
+      random_funtion(str->str, max_length);
+    }while (fp && fp->unique && !add_unique_value(fp, str->str));
+
+    if (memory_shard){
+      g_hash_table_insert(memory_shard->table, g_strdup(row), g_strdup(str->str));
+      g_mutex_unlock(&(memory_shard->mutex));
+    }
 
     *length=str->len;
 
   }else{
     // NULL value
     if (fp && fp->replace_null){
-retry2:
-      g_string_set_size(str, fp->null_max_length + 1);
-      random_funtion(str->str, fp->null_max_length );
-
-      if (fp->unique){
-        if (g_list_find_custom(fp->unique_list,str->str,(GCompareFunc)g_strcmp0)){
-          goto retry2;
-        }
-        fp->unique_list=g_list_prepend(fp->unique_list,g_strdup(str->str));
-      }
+      do{
+        g_string_set_size(str, fp->null_max_length + 1);
+        random_funtion(str->str, fp->null_max_length );
+      }while (fp->unique && !add_unique_value(fp, str->str));
 
       *length=str->len;
     }else{
@@ -204,6 +237,218 @@ gboolean random_uuid_function(GString *str, gchar *row,gulong* length, struct fu
   return random_basic_function(str,row,length,fp,&m_random_uuid);
 }
 
+// Keyed functions: the output only depends on the input and on
+// --masquerade-key, so the same value gets the same replacement on every
+// table and on every run that uses the same key
+
+static
+void masquerade_keystream(const gchar *row, gulong length, guint8 *out, gsize out_len){
+  guint8 digest[32];
+  gsize digest_len, done=0;
+  guint32 counter=0, le_counter;
+  GHmac *hmac=NULL;
+  while (done < out_len){
+    hmac=g_hmac_copy(masquerade_hmac);
+    le_counter=GUINT32_TO_LE(counter);
+    g_hmac_update(hmac, (const guchar *)&le_counter, sizeof(le_counter));
+    g_hmac_update(hmac, (const guchar *)row, length);
+    digest_len=sizeof(digest);
+    g_hmac_get_digest(hmac, digest, &digest_len);
+    g_hmac_unref(hmac);
+    digest_len=MIN(digest_len, out_len - done);
+    memcpy(out + done, digest, digest_len);
+    done+=digest_len;
+    counter++;
+  }
+}
+
+// Letters and digits are replaced by a letter of the same case or by a
+// digit, everything else is kept, so the format of the value is preserved.
+// The masked characters are the numerals of a keyed Feistel permutation
+// (FF1 style), so different values never get the same replacement. The
+// class of every position and the kept characters are the tweak, as they
+// are not changed.
+
+#define FEISTEL_ROUNDS 10
+
+enum hash_class {
+  HASH_KEEP = 0,
+  HASH_DIGIT,
+  HASH_NON_ZERO_DIGIT,
+  HASH_LOWER,
+  HASH_UPPER
+};
+
+struct hash_value {
+  gulong n;
+  gulong *position;
+  guint8 *numeral;
+  guint8 *radix;
+  guint8 *message;
+  gsize tweak_len;
+};
+
+// The message of a round is the round number, the tweak and the other half
+static
+void feistel_round_keystream(struct hash_value *hv, guint8 step, const guint8 *half, gulong half_len, guint8 *out, gulong out_len){
+  hv->message[0]=step;
+  memcpy(hv->message + 1 + hv->tweak_len, half, half_len);
+  masquerade_keystream((const gchar *)hv->message, 1 + hv->tweak_len + half_len, out, out_len);
+}
+
+// A value with a single numeral can't be split in halves, so a binary
+// Feistel network on the smallest even amount of bits that holds the radix
+// is used, and it is applied again until the result is inside the radix
+static
+guint8 permute_numeral(struct hash_value *hv, guint8 numeral, guint8 radix){
+  guint half_bits=radix <= 16 ? 2 : 3;
+  guint8 mask=(1 << half_bits) - 1, l, r, t, k;
+  guint8 step;
+  do {
+    l=numeral >> half_bits;
+    r=numeral & mask;
+    for (step=0; step<FEISTEL_ROUNDS; step++){
+      feistel_round_keystream(hv, step, &r, 1, &k, 1);
+      t=l ^ (k & mask);
+      l=r;
+      r=t;
+    }
+    numeral=(l << half_bits) | r;
+  } while (numeral >= radix);
+  return numeral;
+}
+
+// Each round adds the keystream of one half to the other half, every
+// numeral modulo its own radix, which is reversed by subtracting it
+static
+void permute_numerals(struct hash_value *hv){
+  gulong u=hv->n / 2, v=hv->n - u, i;
+  guint8 *k=g_new(guint8, v), step;
+  for (step=0; step<FEISTEL_ROUNDS; step++){
+    if (step % 2 == 0){
+      feistel_round_keystream(hv, step, hv->numeral + u, v, k, u);
+      for (i=0; i<u; i++)
+        hv->numeral[i]=(hv->numeral[i] + k[i] % hv->radix[i]) % hv->radix[i];
+    }else{
+      feistel_round_keystream(hv, step, hv->numeral, u, k, v);
+      for (i=0; i<v; i++)
+        hv->numeral[u+i]=(hv->numeral[u+i] + k[i] % hv->radix[u+i]) % hv->radix[u+i];
+    }
+  }
+  g_free(k);
+}
+
+static
+enum hash_class get_hash_class(gchar c){
+  if (g_ascii_isdigit(c))
+    return HASH_DIGIT;
+  if (g_ascii_islower(c))
+    return HASH_LOWER;
+  if (g_ascii_isupper(c))
+    return HASH_UPPER;
+  return HASH_KEEP;
+}
+
+// row has *length bytes, as values might have zeros inside. When
+// no_leading_zero is set, a first digit that is not zero is replaced by
+// another digit that is not zero, and a leading zero is kept.
+static
+gboolean hash_basic_function(GString *str, gchar *row, gulong* length, gulong from, gulong to, gboolean no_leading_zero){
+  gulong row_length=*length, i;
+  gulong first_digit = row_length > 0 && row[0] == '-' ? 1 : 0;
+  struct hash_value hv;
+  enum hash_class c;
+  guint8 *tweak=NULL;
+  to=MIN(to, row_length);
+  hv.n=0;
+  hv.tweak_len=2*row_length;
+  hv.position=g_new(gulong, row_length > 0 ? row_length : 1);
+  hv.numeral=g_new(guint8, row_length > 0 ? row_length : 1);
+  hv.radix=g_new(guint8, row_length > 0 ? row_length : 1);
+  hv.message=g_new(guint8, 1 + hv.tweak_len + row_length);
+  tweak=hv.message + 1;
+  for (i=0; i<row_length; i++){
+    c= i >= from && i < to ? get_hash_class(row[i]) : HASH_KEEP;
+    if (c == HASH_DIGIT && no_leading_zero && i == first_digit && row_length > first_digit + 1)
+      c= row[i] == '0' ? HASH_KEEP : HASH_NON_ZERO_DIGIT;
+    tweak[2*i]=c;
+    tweak[2*i+1]= c == HASH_KEEP ? (guint8)row[i] : 0;
+    if (c == HASH_KEEP)
+      continue;
+    hv.position[hv.n]=i;
+    switch (c){
+      case HASH_DIGIT:          hv.radix[hv.n]=10; hv.numeral[hv.n]=row[i] - '0'; break;
+      case HASH_NON_ZERO_DIGIT: hv.radix[hv.n]=9;  hv.numeral[hv.n]=row[i] - '1'; break;
+      case HASH_LOWER:          hv.radix[hv.n]=26; hv.numeral[hv.n]=row[i] - 'a'; break;
+      case HASH_UPPER:          hv.radix[hv.n]=26; hv.numeral[hv.n]=row[i] - 'A'; break;
+      case HASH_KEEP:           break;
+    }
+    hv.n++;
+  }
+
+  if (hv.n == 1)
+    hv.numeral[0]=permute_numeral(&hv, hv.numeral[0], hv.radix[0]);
+  else if (hv.n > 1)
+    permute_numerals(&hv);
+
+  g_string_set_size(str, row_length);
+  memcpy(str->str, row, row_length);
+  for (i=0; i<hv.n; i++){
+    switch (tweak[2*hv.position[i]]){
+      case HASH_DIGIT:          str->str[hv.position[i]]='0' + hv.numeral[i]; break;
+      case HASH_NON_ZERO_DIGIT: str->str[hv.position[i]]='1' + hv.numeral[i]; break;
+      case HASH_LOWER:          str->str[hv.position[i]]='a' + hv.numeral[i]; break;
+      case HASH_UPPER:          str->str[hv.position[i]]='A' + hv.numeral[i]; break;
+    }
+  }
+  g_free(hv.position);
+  g_free(hv.numeral);
+  g_free(hv.radix);
+  g_free(hv.message);
+  *length=str->len;
+  return TRUE;
+}
+
+gboolean hash_string_function(GString *str, gchar *row, gulong* length, struct function_pointer *fp){
+  (void) fp;
+  if (!row)
+    return FALSE;
+  return hash_basic_function(str, row, length, 0, G_MAXULONG, FALSE);
+}
+
+gboolean hash_int_function(GString *str, gchar *row, gulong* length, struct function_pointer *fp){
+  (void) fp;
+  if (!row)
+    return FALSE;
+  return hash_basic_function(str, row, length, 0, G_MAXULONG, TRUE);
+}
+
+gboolean hash_email_function(GString *str, gchar *row, gulong* length, struct function_pointer *fp){
+  (void) fp;
+  if (!row)
+    return FALSE;
+  gulong at=*length;
+  while (at > 0 && row[at-1] != '@')
+    at--;
+  return hash_basic_function(str, row, length, 0, at > 0 ? at - 1 : G_MAXULONG, FALSE);
+}
+
+gboolean hash_uuid_function(GString *str, gchar *row, gulong* length, struct function_pointer *fp){
+  (void) fp;
+  if (!row)
+    return FALSE;
+  guint8 b[16];
+  masquerade_keystream(row, *length, b, sizeof(b));
+  // Version 4 and RFC 4122 variant
+  b[6] = (b[6] & 0x0f) | 0x40;
+  b[8] = (b[8] & 0x3f) | 0x80;
+  g_string_printf(str, "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+                  b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7],
+                  b[8], b[9], b[10], b[11], b[12], b[13], b[14], b[15]);
+  *length=str->len;
+  return TRUE;
+}
+
 gboolean apply_format_item(GString *str, gchar *row, struct format_item *fi){
   struct format_item_file *fid=NULL;
   gboolean cont=TRUE;
@@ -281,30 +526,99 @@ gboolean random_format_function(GString *str, gchar *row, gulong* max_len, struc
   return TRUE;
 }
 
+struct regex_rule{
+  pcre2_code *re;
+  PCRE2_SPTR replacement;
+  PCRE2_SIZE replacement_length;
+};
+
+// Match data and scratch buffer are per thread, so regex_function does not
+// allocate once they have grown to the largest value seen
+struct regex_thread_buffers{
+  pcre2_match_data *match_data;
+  guint32 ovector_count;
+  GString *input;
+};
+
+static
+void free_regex_thread_buffers(gpointer data){
+  struct regex_thread_buffers *rtb=data;
+  if (rtb->match_data)
+    pcre2_match_data_free(rtb->match_data);
+  g_string_free(rtb->input, TRUE);
+  g_free(rtb);
+}
+
+static GPrivate regex_thread_buffers_key = G_PRIVATE_INIT(free_regex_thread_buffers);
+
+static
+struct regex_thread_buffers *get_regex_thread_buffers(pcre2_code *re){
+  struct regex_thread_buffers *rtb=g_private_get(&regex_thread_buffers_key);
+  guint32 capture_count=0;
+  if (rtb == NULL){
+    rtb=g_new0(struct regex_thread_buffers, 1);
+    rtb->input=g_string_sized_new(256);
+    g_private_set(&regex_thread_buffers_key, rtb);
+  }
+  pcre2_pattern_info(re, PCRE2_INFO_CAPTURECOUNT, &capture_count);
+  if (rtb->match_data == NULL || rtb->ovector_count < capture_count + 1){
+    if (rtb->match_data)
+      pcre2_match_data_free(rtb->match_data);
+    rtb->ovector_count=capture_count + 1;
+    rtb->match_data=pcre2_match_data_create(rtb->ovector_count, NULL);
+  }
+  return rtb;
+}
+
+static
+int regex_substitute(struct regex_rule *rule, pcre2_match_data *match_data, const gchar *subject, gsize subject_length, GString *str){
+  PCRE2_SIZE outlen;
+  int rc;
+  if (str->allocated_len < subject_length + rule->replacement_length + 1)
+    g_string_set_size(str, subject_length + rule->replacement_length);
+  outlen=str->allocated_len;
+  rc=pcre2_substitute(rule->re, (PCRE2_SPTR)subject, subject_length, 0,
+                      PCRE2_SUBSTITUTE_GLOBAL | PCRE2_SUBSTITUTE_EXTENDED | PCRE2_SUBSTITUTE_OVERFLOW_LENGTH,
+                      match_data, NULL, rule->replacement, rule->replacement_length, (PCRE2_UCHAR *)str->str, &outlen);
+  if (rc == PCRE2_ERROR_NOMEMORY){
+    // outlen has the length needed, including the trailing zero
+    g_string_set_size(str, outlen);
+    outlen=str->allocated_len;
+    rc=pcre2_substitute(rule->re, (PCRE2_SPTR)subject, subject_length, 0,
+                        PCRE2_SUBSTITUTE_GLOBAL | PCRE2_SUBSTITUTE_EXTENDED,
+                        match_data, NULL, rule->replacement, rule->replacement_length, (PCRE2_UCHAR *)str->str, &outlen);
+  }
+  g_string_set_size(str, rc < 0 ? 0 : outlen);
+  return rc;
+}
+
 gboolean regex_function(GString *str, gchar *row, gulong* max_len, struct function_pointer *fp){
-  pcre2_code *tre=NULL;
   GList *l=fp->parse;
-  //GString *new_r= g_string_new(*r);
-  pcre2_match_data *match_data = NULL;
-  PCRE2_UCHAR outputbuffer[1024];
-  PCRE2_SPTR replacement=NULL;
-  size_t rlength=0;
-  PCRE2_SIZE outlen=1024;
-  while (l){
-    tre=l->data;
-    match_data=pcre2_match_data_create_from_pattern(tre, NULL);
-    l=l->next;
-    replacement=l->data;
-    l=l->next;
-    rlength = strlen((gchar *)replacement);
-    int rc =pcre2_substitute(tre, (PCRE2_SPTR)row, strlen(row), 0, PCRE2_SUBSTITUTE_GLOBAL | PCRE2_SUBSTITUTE_EXTENDED, match_data, NULL, replacement, rlength, outputbuffer, &outlen);
+  struct regex_rule *rule=NULL;
+  struct regex_thread_buffers *rtb=NULL;
+  const gchar *subject=row;
+  gsize subject_length=0;
+  int rc;
+  if (!row)
+    return FALSE;
+  subject_length=strlen(row);
+  for (; l; l=l->next){
+    rule=l->data;
+    rtb=get_regex_thread_buffers(rule->re);
+    // Each rule is applied to the output of the previous one
+    if (subject != row){
+      g_string_assign(rtb->input, str->str);
+      subject=rtb->input->str;
+      subject_length=rtb->input->len;
+    }
+    rc=regex_substitute(rule, rtb->match_data, subject, subject_length, str);
     if (rc < 0){
-      g_critical("Error found on pcre2_substitute: %s | %s", row, replacement);
+      g_critical("Error found on pcre2_substitute: %s | %s", row, (gchar *)rule->replacement);
+      g_string_assign(str, row);
     }
-    g_string_printf(str, "%s", outputbuffer);
+    subject=str->str;
   }
   *max_len=str->len;
-//  g_message("new_r->str: %s",new_r->str );
   return TRUE;
 }
 
@@ -365,7 +679,7 @@ void parse_basic(struct function_pointer * fp, gchar *val){
     buffer[i]='\0';*/
     val=read_word(buffer,val);
     if (g_str_has_prefix(buffer,"WITH_MEM")){
-      fp->memory=g_hash_table_new ( g_str_hash, g_str_equal );
+      fp->memory=new_masquerade_shards(g_free);
     }else if (g_str_has_prefix(buffer,"REPLACE_NULL")){
       fp->replace_null=TRUE;
       val++;
@@ -383,6 +697,7 @@ void parse_basic(struct function_pointer * fp, gchar *val){
         m_error("REPLACE_NULL receives an integer value as paramter that limits the max length of the integer value");
     }else if (g_str_has_prefix(buffer,"UNIQUE")){
       fp->unique=TRUE;
+      fp->unique_set=new_masquerade_shards(NULL);
     }else if (g_str_has_prefix(buffer,"MAX_LENGTH")){
       val++;
 /*      i=0;
@@ -402,7 +717,7 @@ void parse_basic(struct function_pointer * fp, gchar *val){
 void parse_regex_function(struct function_pointer * fp, gchar *val){
   char buffer[256];
   guint i=0;
-  pcre2_code **re = NULL;
+  struct regex_rule *rule = NULL;
   gboolean even=TRUE;
   while (*val != '\0'){
     if (*val == '\''){
@@ -418,12 +733,15 @@ void parse_regex_function(struct function_pointer * fp, gchar *val){
       }
       buffer[i]='\0';
       if (even){
-        re=g_new0(pcre2_code *,1);
-        init_regex(re,buffer);
-        fp->parse=g_list_append(fp->parse,*re);
+        rule=g_new0(struct regex_rule, 1);
+        init_regex(&(rule->re),buffer);
+        // JIT is optional, pcre2 falls back to the interpreter when it fails
+        pcre2_jit_compile(rule->re, PCRE2_JIT_COMPLETE);
+        fp->parse=g_list_append(fp->parse,rule);
         even=FALSE;
       }else{
-        fp->parse=g_list_append(fp->parse,g_strdup(buffer));
+        rule->replacement=(PCRE2_SPTR)g_strdup(buffer);
+        rule->replacement_length=strlen(buffer);
         even=TRUE;
       }
 
@@ -433,8 +751,8 @@ void parse_regex_function(struct function_pointer * fp, gchar *val){
       val++;
   }
 
-  if (g_list_length(fp->parse)%2 != 0)
-    g_error("Parsing regex function failed. Elements found: %d but even amount of elements are allowed", g_list_length(fp->parse));
+  if (!even)
+    g_error("Parsing regex function failed. Elements found: %d but even amount of elements are allowed", g_list_length(fp->parse) * 2 - 1);
 
 }
 
@@ -637,6 +955,18 @@ fun_ptr get_function_pointer_for (gchar *function_char){
   if (g_str_has_prefix(function_char,"random_uuid"))
     return &random_uuid_function;
 
+  if (g_str_has_prefix(function_char,"hash_string"))
+    return &hash_string_function;
+
+  if (g_str_has_prefix(function_char,"hash_int"))
+    return &hash_int_function;
+
+  if (g_str_has_prefix(function_char,"hash_email"))
+    return &hash_email_function;
+
+  if (g_str_has_prefix(function_char,"hash_uuid"))
+    return &hash_uuid_function;
+
   if (g_str_has_prefix(function_char,"apply"))
     return &apply_function;
 
@@ -670,7 +1000,7 @@ struct function_pointer * init_function_pointer(gchar *value){
   fp->delimiters=NULL;
   fp->is_pre=FALSE;
   fp->unique=FALSE;
-  fp->unique_list=NULL;
+  fp->unique_set=NULL;
   g_debug("init_function_pointer: %s", value);
   if (g_str_has_prefix(value,"random_format")){
     parse_random_format(fp, g_strdup(&(fp->value[14])));
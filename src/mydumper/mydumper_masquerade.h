@@ -14,6 +14,7 @@
 #include "mydumper.h"
 
 #define REGEX_MAX_LEN 2048
+#define MASQUERADE_SHARDS 64
 
 enum format_item_type {
   FORMAT_ITEM_FILE,
@@ -49,6 +50,13 @@ struct format_item{
 
 
 
+// The memory and the unique values of a function are shared by all the
+// threads dumping the table, split in MASQUERADE_SHARDS to reduce contention
+struct masquerade_shard{
+  GMutex mutex;
+  GHashTable *table;
+};
+
 struct regex_item{
   pcre2_code **re;
   struct format_item *fi;  
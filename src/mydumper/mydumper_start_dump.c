@@ -38,6 +38,7 @@
 #include "mydumper_global.h"
 #include "mydumper_create_jobs.h"
 #include "mydumper_file_handler.h"
+#include "mydumper_transportable.h"
 #include "../logging.h"
 
 /* Program options */
@@ -427,6 +428,19 @@ void detect_quote_character(MYSQL *conn)
   mysql_free_result(res);
 }
 
+// --server-outfile: an empty secure_file_priv lets the server write into the
+// output directory, and NULL disables SELECT ... INTO OUTFILE
+static
+void detect_secure_file_priv(MYSQL *conn){
+  struct M_ROW *mr = m_store_result_single_row(conn, "SELECT @@secure_file_priv", "Error getting secure_file_priv",NULL);
+  if (!mr->res || !mr->row || !mr->row[0])
+    m_critical("--server-outfile needs secure_file_priv to be enabled on the server");
+  secure_file_priv=g_strdup(mr->row[0]);
+  m_store_result_row_free(mr);
+  if (*secure_file_priv)
+    g_message("Data files are going to be written in %s and moved to %s", secure_file_priv, dump_directory);
+}
+
 static
 void detect_sql_mode(MYSQL *conn){
   struct M_ROW *mr = m_store_result_single_row(conn, "SELECT @@SQL_MODE", "Error getting SQL_MODE",NULL);
@@ -503,6 +517,8 @@ MYSQL *create_main_connection(GOptionContext *context) {
   detect_quote_character(conn);
   initialize_headers();
   initialize_write();
+  if (server_outfile)
+    detect_secure_file_priv(conn);
 
   switch (get_product()) {
   case SERVER_TYPE_MYSQL:
@@ -785,6 +801,8 @@ void print_dbt_on_metadata_gstring(struct db_table *dbt, GString *data){
     g_string_append_printf(data,"is_sequence = 1\n");
   if (dbt->is_view)
     g_string_append_printf(data,"is_view = 1\n");
+  if (dbt->transportable_tablespace)
+    g_string_append_printf(data,"transportable_tablespace = 1\n");
   if (dbt->checksum.data)
     g_string_append_printf(data,"data_checksum = %s\n", dbt->checksum.data);
   if (dbt->checksum.schema)
@@ -801,7 +819,7 @@ void print_dbt_on_metadata(FILE *mdfile, struct db_table *dbt){
   GString *data = g_string_sized_new(100);
   print_dbt_on_metadata_gstring(dbt, data);
   fprintf(mdfile, "%s", data->str);
-  if (check_row_count && !dbt->object_to_export.no_data && (dbt->rows != dbt->rows_total)) {
+  if (check_row_count && !dbt->object_to_export.no_data && !dbt->transportable_tablespace && (dbt->rows != dbt->rows_total)) {
     m_critical("Row count mismatch found for %s.%s: got %u of %u expected",
                dbt->database->source_database, dbt->table, dbt->rows, dbt->rows_total);
   }
@@ -1267,6 +1285,13 @@ void start_dump(struct configuration *conf, GOptionContext *context) {
     acquire_global_lock_function(conn);
   }
 
+  if (transportable_tablespace_size > 0 && !no_data){
+    if (acquire_global_lock_function != NULL)
+      start_transportable_tablespaces(conn);
+    else
+      g_warning("Transportable tablespaces need a global lock, all the tables will be dumped as rows");
+  }
+
   // TODO: this should be deleted on future releases. 
   server_version= mysql_get_server_version(conn);
   if (server_version < 40108) {
@@ -1480,6 +1505,7 @@ void start_dump(struct configuration *conf, GOptionContext *context) {
     g_message("Waiting database finish");
   }
   g_async_queue_pop(conf->db_ready);
+  start_copy_tablespaces();
 
   // At this point all schema jobs are completed
 
@@ -1664,6 +1690,8 @@ void start_dump(struct configuration *conf, GOptionContext *context) {
     g_message("Main connection closed");
   }
 
+  wait_copy_tablespaces();
+
   // There are scenarios where we need to wait files to flush to disk  
   wait_close_files();
   dump_summary_set_tables(g_hash_table_size(all_dbts));
@@ -126,8 +126,13 @@ struct chunk_step_item *new_string_step_item(
 }
 
 void free_string_step(union chunk_step * cs){
-  if (cs)
+  if (cs){
+    if (cs->string_step.boundaries)
+      g_list_free_full(cs->string_step.boundaries, g_free);
+    g_list_free_full(cs->string_step.sampled_boundaries, g_free);
+    g_free(cs->string_step.sampled_prefix);
     g_free(cs);
+  }
 }
 
 void free_string_step_item(struct chunk_step_item * csi){
@@ -654,6 +659,12 @@ guint process_string_chunk_step(struct table_job *tj, struct chunk_step_item *cs
 
 
   
+  // Boundaries were computed up-front by the sampling pass, there is nothing to split
+  if (cs->string_step.fixed_boundaries){
+    csi->chunk_step->string_step.str_cur=csi->chunk_step->string_step.str_max;
+    goto execute_string_chunk;
+  }
+
 retry_split_chunk:
 //  csi->chunk_step->string_step.str_cur=g_strdup(csi->chunk_step->string_step.str_min);
 //  csi->chunk_step->string_step.str_prev_cur=NULL;
@@ -891,7 +902,7 @@ retry:
       if (rows > tj->dbt->min_chunk_step_size){
         csi->next = initialize_chunk_step_item(td->thrconn, tj->dbt, csi->position + 1, rows, csi->where);
         if (csi->next){
-          csi->next->multicolumn=FALSE;
+          csi->next->multicolumn= can_go_deeper_on_chunk_step_item(tj->dbt, csi->next);
           trace("Thread %d: I-Chunk 2: New next with where %s | rows: %lld", td->thread_id, csi->where->str, rows);
         }
       }else{
@@ -937,7 +948,7 @@ retry:
     trace("Thread %d: I-Chunk 3: going down", td->thread_id);
     // Multi column
     if (csi->next->needs_refresh)
-      if (!refresh_string_min_max(td->thrconn, tj->dbt, csi->next)){
+      if (!refresh_chunk_step_item(td->thrconn, tj->dbt, csi->next)){
         trace("Thread %d: I-Chunk 3: No min and max found", td->thread_id);
         goto update_min;
       }
@@ -1041,13 +1052,28 @@ update_min:
     csi->multicolumn=tj->dbt->multicolumn;
 
   if (csi->next!=NULL){
-    free_string_step_item(csi->next);
+    csi->next->chunk_functions.free(csi->next);
     csi->next=NULL;
   }
   g_mutex_unlock(csi->mutex);
   return 0;
 }
 
+static
+gboolean next_sampled_string_range(struct chunk_step_item *csi){
+  struct string_step *ss=&(csi->chunk_step->string_step);
+  gboolean r=FALSE;
+  g_mutex_lock(csi->mutex);
+  if (ss->next_boundaries){
+    ss->str_min=ss->str_max;
+    ss->str_max=ss->next_boundaries->data;
+    ss->next_boundaries=ss->next_boundaries->next;
+    r=TRUE;
+  }
+  g_mutex_unlock(csi->mutex);
+  return r;
+}
+
 void process_string_chunk(struct table_job *tj, struct chunk_step_item *csi){
   struct thread_data *td = tj->td;
   struct db_table *dbt = tj->dbt;
@@ -1056,30 +1082,33 @@ void process_string_chunk(struct table_job *tj, struct chunk_step_item *csi){
 
 
   // First step, we need this to process the one time prefix
-  g_string_set_size(tj->where,0);
-  if (process_string_chunk_step(tj, csi)){
-    if (machine_log_json_enabled()) {
-      gchar *thread_id = g_strdup_printf("%u", td->thread_id);
-      machine_log_event(G_LOG_DOMAIN, G_LOG_LEVEL_MESSAGE,
-                        "MESSAGE", "dump job cancelled",
-                        "EVENT", "dump_job",
-                        "PHASE", "dump_data",
-                        "STATUS", "cancelled",
-                        "THREAD_ID", thread_id,
-                        "DB", dbt->database->source_database,
-                        "TABLE", dbt->table,
-                        NULL);
-      g_free(thread_id);
-    } else {
-      g_message("Thread %d: Job has been cacelled",td->thread_id);
+  do {
+    g_string_set_size(tj->where,0);
+    if (process_string_chunk_step(tj, csi)){
+      if (machine_log_json_enabled()) {
+        gchar *thread_id = g_strdup_printf("%u", td->thread_id);
+        machine_log_event(G_LOG_DOMAIN, G_LOG_LEVEL_MESSAGE,
+                          "MESSAGE", "dump job cancelled",
+                          "EVENT", "dump_job",
+                          "PHASE", "dump_data",
+                          "STATUS", "cancelled",
+                          "THREAD_ID", thread_id,
+                          "DB", dbt->database->source_database,
+                          "TABLE", dbt->table,
+                          NULL);
+        g_free(thread_id);
+      } else {
+        g_message("Thread %d: Job has been cacelled",td->thread_id);
+      }
+      return;
     }
-    return;
-  }
-  g_atomic_int_inc(dbt->chunks_completed);
+    g_atomic_int_inc(dbt->chunks_completed);
 //  if (csi->prefix)
 //    g_free(csi->prefix);
 //  csi->prefix=NULL;
-  csi->include_null=FALSE;
+    csi->include_null=FALSE;
+    // Nested sampled chunks walk the rest of their ranges under the same prefix
+  } while (next_sampled_string_range(csi));
 
   // Processing the remaining steps
   g_mutex_lock(csi->mutex);
@@ -1120,9 +1149,176 @@ void update_string_where_on_gstring(GString *where, gboolean include_null, GStri
 //  g_message("update_string_where_on_gstring:: where = |%s|", where->str);
 }
 
+// Sampled chunks are half-open ranges [str_min, str_max), where NULL means unbounded
+void update_sampled_string_where_on_gstring(GString *where, gboolean include_null, GString *prefix, gchar * field, gchar *str_min, gchar *str_max){
+  if (prefix && prefix->len>0){
+    g_string_append_printf(where,"(%s AND ",
+                          prefix->str);
+  }
+  if (include_null){
+    g_string_append_printf(where,"(%s%s%s IS NULL OR", identifier_quote_character_str, field, identifier_quote_character_str);
+  }
+  g_string_append(where,"(");
+  if (str_min)
+    g_string_append_printf(where, "%s%s%s >= '%s'", identifier_quote_character_str, field, identifier_quote_character_str, str_min);
+  if (str_min && str_max)
+    g_string_append(where, " AND ");
+  if (str_max)
+    g_string_append_printf(where, "%s%s%s < '%s'", identifier_quote_character_str, field, identifier_quote_character_str, str_max);
+  if (!str_min && !str_max)
+    g_string_append(where, "1=1");
+  if (include_null)
+    g_string_append(where,")");
+  g_string_append(where,")");
+  if (prefix && prefix->len>0)
+    g_string_append(where,")");
+}
+
 void update_where_on_string_step(struct chunk_step_item * csi){
   g_string_set_size(csi->where,0);
-  update_string_where_on_gstring(csi->where, csi->include_null, csi->prefix, csi->field, csi->chunk_step->string_step.str_min, csi->chunk_step->string_step.str_cur);
+  if (csi->chunk_step->string_step.fixed_boundaries)
+    update_sampled_string_where_on_gstring(csi->where, csi->include_null, csi->prefix, csi->field, csi->chunk_step->string_step.str_min, csi->chunk_step->string_step.str_cur);
+  else
+    update_string_where_on_gstring(csi->where, csi->include_null, csi->prefix, csi->field, csi->chunk_step->string_step.str_min, csi->chunk_step->string_step.str_cur);
+}
+
+// Reads every step-th value of the column in index order and returns them
+// escaped and without duplicates. When the server supports window functions
+// the sampling is done server side, otherwise we stream the index.
+static
+GList *get_string_boundaries_from_sample(MYSQL *conn, struct db_table *dbt, GString *prefix, gchar *field, guint64 step){
+  gboolean server_side=server_support_window_functions();
+  GString *where=g_string_new("");
+  g_string_append_printf(where, "%s%s%s IS NOT NULL", identifier_quote_character_str, field, identifier_quote_character_str);
+  if (where_option)
+    g_string_append_printf(where, " AND (%s)", where_option);
+  if (prefix && prefix->len>0)
+    g_string_append_printf(where, " AND %s", prefix->str);
+
+  gchar *query = NULL;
+  if (server_side)
+    query = g_strdup_printf(
+                        "SELECT %s %s%s%s FROM (SELECT %s%s%s, ROW_NUMBER() OVER (ORDER BY %s%s%s) AS mydumper_rn FROM %s%s%s.%s%s%s WHERE %s) mydumper_sample WHERE mydumper_rn %% %"G_GUINT64_FORMAT" = 0",
+                        is_mysql_like() ? "/*!40001 SQL_NO_CACHE */": "",
+                        identifier_quote_character_str, field, identifier_quote_character_str,
+                        identifier_quote_character_str, field, identifier_quote_character_str,
+                        identifier_quote_character_str, field, identifier_quote_character_str,
+                        identifier_quote_character_str, dbt->database->source_database, identifier_quote_character_str, identifier_quote_character_str, dbt->table, identifier_quote_character_str,
+                        where->str, step);
+  else
+    query = g_strdup_printf(
+                        "SELECT %s %s%s%s FROM %s%s%s.%s%s%s WHERE %s ORDER BY %s%s%s",
+                        is_mysql_like() ? "/*!40001 SQL_NO_CACHE */": "",
+                        identifier_quote_character_str, field, identifier_quote_character_str,
+                        identifier_quote_character_str, dbt->database->source_database, identifier_quote_character_str, identifier_quote_character_str, dbt->table, identifier_quote_character_str,
+                        where->str,
+                        identifier_quote_character_str, field, identifier_quote_character_str);
+  g_string_free(where, TRUE);
+  trace("get_string_boundaries_from_sample: %s", query);
+  MYSQL_RES *res = m_use_result(conn, query, m_warning, "Failed to sample string primary key on `%s`.`%s`", dbt->database->source_database, dbt->table);
+  g_free(query);
+  if (!res)
+    return NULL;
+
+  GList *boundaries=NULL;
+  gchar *last=NULL;
+  guint64 n=0;
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res))){
+    n++;
+    if (!server_side && n % step != 0)
+      continue;
+    gulong *lengths = mysql_fetch_lengths(res);
+    gchar *escaped = g_new(gchar, lengths[0] * 2 + 1);
+    mysql_real_escape_string(conn, escaped, row[0], lengths[0]);
+    if (last && !g_strcmp0(last, escaped)){
+      g_free(escaped);
+      continue;
+    }
+    boundaries=g_list_prepend(boundaries, escaped);
+    last=escaped;
+  }
+  mysql_free_result(res);
+  return g_list_reverse(boundaries);
+}
+
+// Builds all the chunks of a string primary key at once from a sample of the
+// index. The first chunk is returned and the rest are pushed to chunks_queue,
+// so every thread can start immediately on a balanced range.
+struct chunk_step_item *new_sampled_string_step_items(MYSQL *conn, struct db_table *dbt, GString *prefix, gchar *field, guint64 rows, guint64 step){
+  if (step == 0 || rows / step < 2)
+    return NULL;
+  GList *boundaries=get_string_boundaries_from_sample(conn, dbt, prefix, field, step);
+  if (!boundaries)
+    return NULL;
+  g_message("`%s`.`%s` will be split in %u chunks based on a sample of its string primary key", dbt->database->source_database, dbt->table, g_list_length(boundaries) + 1);
+
+  struct chunk_step_item *first=NULL, *csi=NULL;
+  gchar *str_min=NULL, *str_max=NULL;
+  guint64 part=0;
+  GList *l=boundaries;
+  do{
+    str_max= l ? l->data : NULL;
+    csi=new_string_step_item(part==0, prefix, field, 0, FALSE, 0, str_min, str_max, step, part, FALSE, FALSE, NULL, 0, FALSE, step);
+    csi->chunk_step->string_step.fixed_boundaries=TRUE;
+    if (first)
+      g_async_queue_push(dbt->chunks_queue, csi);
+    else
+      first=csi;
+    str_min=str_max;
+    part++;
+    l= l ? l->next : NULL;
+  } while (str_max);
+  g_list_free(boundaries);
+  return first;
+}
+
+static
+void set_sampled_string_boundaries(struct chunk_step_item *csi, GList *boundaries){
+  struct string_step *ss=&(csi->chunk_step->string_step);
+  if (ss->boundaries)
+    g_list_free_full(ss->boundaries, g_free);
+  // The last range is open ended
+  ss->boundaries=g_list_append(boundaries, NULL);
+  ss->str_min=NULL;
+  ss->str_max=ss->boundaries->data;
+  ss->next_boundaries=ss->boundaries->next;
+  csi->include_null=TRUE;
+}
+
+// Nested levels can not push chunks to chunks_queue as they are processed by
+// the thread that owns the prefix, so a single item walks all the ranges
+struct chunk_step_item *new_nested_sampled_string_step_item(MYSQL *conn, struct db_table *dbt, GString *prefix, gchar *field, guint position, guint64 rows, guint64 step){
+  if (step == 0 || rows / step < 2)
+    return NULL;
+  GList *boundaries=get_string_boundaries_from_sample(conn, dbt, prefix, field, step);
+  if (!boundaries)
+    return NULL;
+  struct chunk_step_item *csi=new_string_step_item(TRUE, prefix, field, 0, FALSE, 0, NULL, NULL, step, 0, FALSE, FALSE, NULL, position, FALSE, step);
+  csi->chunk_step->string_step.fixed_boundaries=TRUE;
+  csi->chunk_step->string_step.sampling_step=step;
+  csi->chunk_step->string_step.sampled_prefix=g_strdup(prefix ? prefix->str : "");
+  csi->chunk_step->string_step.sampled_boundaries=g_list_copy_deep(boundaries, (GCopyFunc) g_strdup, NULL);
+  set_sampled_string_boundaries(csi, boundaries);
+  return csi;
+}
+
+// The level is walked again for every step of the parent level. The sample
+// is only taken when the prefix range changed, and a range with less rows
+// than two sampling steps in the EXPLAIN is a single chunk without sampling.
+gboolean refresh_sampled_string_boundaries(MYSQL *conn, struct db_table *dbt, struct chunk_step_item *csi){
+  struct string_step *ss=&(csi->chunk_step->string_step);
+  const gchar *prefix=csi->prefix ? csi->prefix->str : "";
+  if (ss->sampled_prefix == NULL || g_strcmp0(ss->sampled_prefix, prefix)){
+    g_list_free_full(ss->sampled_boundaries, g_free);
+    ss->sampled_boundaries= csi->prefix && csi->prefix->len > 0 && get_rows_from_explain(conn, dbt, csi->prefix, csi->field) / ss->sampling_step < 2 ?
+                              NULL:
+                              get_string_boundaries_from_sample(conn, dbt, csi->prefix, csi->field, ss->sampling_step);
+    g_free(ss->sampled_prefix);
+    ss->sampled_prefix=g_strdup(prefix);
+  }
+  set_sampled_string_boundaries(csi, g_list_copy_deep(ss->sampled_boundaries, (GCopyFunc) g_strdup, NULL));
+  return TRUE;
 }
 
 void determine_if_we_can_go_deeper_in_string_chunk_step_item( struct chunk_step_item * csi, guint64 rows){
@@ -35,6 +35,12 @@ struct string_step {
   gchar *str_cur;
   gchar *str_max;
   guint left_length;
+  gboolean fixed_boundaries;
+  guint64 sampling_step;
+  gchar *sampled_prefix;
+  GList *sampled_boundaries;
+  GList *boundaries;
+  GList *next_boundaries;
   GCond *cond;
   GMutex *cond_mutex;
 };
@@ -50,3 +56,8 @@ struct chunk_step_item *new_string_step_item(
     gboolean multicolumn, guint64 rows_in_explain);
 
 void update_string_where_on_gstring(GString *where, gboolean include_null, GString *prefix, gchar * field, gchar *str_min, gchar*str_max);
+void update_sampled_string_where_on_gstring(GString *where, gboolean include_null, GString *prefix, gchar * field, gchar *str_min, gchar *str_max);
+struct chunk_step_item *new_sampled_string_step_items(MYSQL *conn, struct db_table *dbt, GString *prefix, gchar *field, guint64 rows, guint64 step);
+struct chunk_step_item *new_nested_sampled_string_step_item(MYSQL *conn, struct db_table *dbt, GString *prefix, gchar *field, guint position, guint64 rows, guint64 step);
+gboolean refresh_string_min_max(MYSQL *conn, struct db_table *dbt, struct chunk_step_item *csi);
+gboolean refresh_sampled_string_boundaries(MYSQL *conn, struct db_table *dbt, struct chunk_step_item *csi);
@@ -25,6 +25,7 @@
 #include "mydumper_global.h"
 #include "mydumper_chunks.h"
 #include "mydumper_common.h"
+#include "mydumper_transportable.h"
 
 // Extern
 extern guint64 min_integer_chunk_step_size;
@@ -38,7 +39,35 @@ static GHashTable *character_set_hash=NULL;
 // Bulk metadata prefetch caches (populated when --bulk-metadata-prefetch is used)
 static GHashTable *json_fields_cache = NULL;       // "db.table" -> GINT_TO_POINTER(1) if has json
 static GHashTable *generated_fields_cache = NULL;  // "db.table" -> GINT_TO_POINTER(1) if has generated
+static GHashTable *index_cache = NULL;             // "db.table" -> GList of index rows, see INDEX_ROW_FIELDS
+static GHashTable *triggers_cache = NULL;          // "db.table" -> GINT_TO_POINTER(1) if has triggers
+static GHashTable *selectable_fields_cache = NULL; // "db.table" -> GString with the non generated columns
 static gboolean metadata_prefetch_done = FALSE;
+static gboolean indexes_prefetch_done = FALSE;
+static gboolean triggers_prefetch_done = FALSE;
+
+// Index rows keep the layout of SHOW INDEX: Table, Non_unique, Key_name,
+// Seq_in_index, Column_name, Collation, Cardinality and Visible at the end
+#define INDEX_ROW_FIELDS 8
+#define INDEX_ROW_VISIBLE 7
+
+static
+void free_index_row(gchar **row){
+  guint i;
+  for (i=0; i<INDEX_ROW_FIELDS; i++)
+    g_free(row[i]);
+  g_free(row);
+}
+
+static
+void free_index_rows(GList *rows){
+  g_list_free_full(rows, (GDestroyNotify)free_index_row);
+}
+
+static
+void free_selectable_fields(GString *fields){
+  g_string_free(fields, TRUE);
+}
 
 void initialize_table(){
   all_dbts_mutex = g_mutex_new();
@@ -47,6 +76,9 @@ void initialize_table(){
   // Initialize metadata caches (populated by prefetch_table_metadata when --bulk-metadata-prefetch)
   json_fields_cache = g_hash_table_new_full(g_str_hash, g_str_equal, &g_free, NULL);
   generated_fields_cache = g_hash_table_new_full(g_str_hash, g_str_equal, &g_free, NULL);
+  index_cache = g_hash_table_new_full(g_str_hash, g_str_equal, &g_free, (GDestroyNotify)free_index_rows);
+  triggers_cache = g_hash_table_new_full(g_str_hash, g_str_equal, &g_free, NULL);
+  selectable_fields_cache = g_hash_table_new_full(g_str_hash, g_str_equal, &g_free, (GDestroyNotify)free_selectable_fields);
 }
 
 void finalize_table(){
@@ -56,15 +88,102 @@ void finalize_table(){
   // Clean up metadata caches
   if (json_fields_cache) g_hash_table_destroy(json_fields_cache);
   if (generated_fields_cache) g_hash_table_destroy(generated_fields_cache);
+  if (index_cache) g_hash_table_destroy(index_cache);
+  if (triggers_cache) g_hash_table_destroy(triggers_cache);
+  if (selectable_fields_cache) g_hash_table_destroy(selectable_fields_cache);
+}
+
+static
+gboolean server_support_index_visibility(){
+  return is_mysql_like() && get_product() != SERVER_TYPE_MARIADB && get_major() >= 8;
+}
+
+// Prefetch the indexes of all the tables, PRIMARY and unique ones first as
+// SHOW INDEX does. information_schema has no index creation order, so the
+// indexes of a class are sorted by name and get_primary_key() must not rely
+// on the order of the indexes
+static
+void prefetch_indexes(MYSQL *conn){
+  gchar *query = g_strdup_printf(
+      "SELECT TABLE_SCHEMA, TABLE_NAME, NON_UNIQUE, INDEX_NAME, SEQ_IN_INDEX, COLUMN_NAME, COLLATION, CARDINALITY, %s "
+      "FROM information_schema.STATISTICS "
+      "ORDER BY TABLE_SCHEMA, TABLE_NAME, INDEX_NAME='PRIMARY' DESC, NON_UNIQUE, INDEX_NAME, SEQ_IN_INDEX",
+      server_support_index_visibility() ? "IS_VISIBLE" : "NULL");
+  MYSQL_RES *result = m_store_result(conn, query, m_warning, "Failed to prefetch index metadata", NULL);
+  g_free(query);
+  if (!result)
+    return;
+  MYSQL_ROW row;
+  gchar *cache_key = NULL, *previous_key = NULL;
+  GList *rows = NULL;
+  guint table_count = 0, i;
+  while ((row = mysql_fetch_row(result))) {
+    cache_key = g_strdup_printf("%s.%s", row[0], row[1]);
+    if (previous_key && g_strcmp0(previous_key, cache_key)){
+      g_hash_table_insert(index_cache, previous_key, g_list_reverse(rows));
+      rows = NULL;
+      table_count++;
+    }else
+      g_free(previous_key);
+    previous_key = cache_key;
+    gchar **index_row = g_new0(gchar *, INDEX_ROW_FIELDS);
+    for (i=0; i<INDEX_ROW_FIELDS; i++)
+      index_row[i] = g_strdup(row[i+1]);
+    rows = g_list_prepend(rows, index_row);
+  }
+  if (previous_key){
+    g_hash_table_insert(index_cache, previous_key, g_list_reverse(rows));
+    table_count++;
+  }
+  mysql_free_result(result);
+  indexes_prefetch_done = TRUE;
+  g_message("Prefetched indexes of %u tables", table_count);
 }
 
-// Prefetch JSON and generated column metadata in bulk queries
+// Prefetch the list of columns to SELECT, only needed on tables with
+// generated columns unless --complete-insert is used
+static
+void prefetch_selectable_fields(MYSQL *conn){
+  const char *query = complete_insert ?
+      "SELECT TABLE_SCHEMA, TABLE_NAME, COLUMN_NAME FROM information_schema.COLUMNS "
+      "WHERE extra NOT LIKE '%VIRTUAL GENERATED%' AND extra NOT LIKE '%STORED GENERATED%' "
+      "ORDER BY TABLE_SCHEMA, TABLE_NAME, ORDINAL_POSITION":
+      "SELECT C.TABLE_SCHEMA, C.TABLE_NAME, C.COLUMN_NAME FROM information_schema.COLUMNS C "
+      "JOIN (SELECT DISTINCT TABLE_SCHEMA, TABLE_NAME FROM information_schema.COLUMNS "
+      "WHERE extra LIKE '%GENERATED%' AND extra NOT LIKE '%DEFAULT_GENERATED%') G USING (TABLE_SCHEMA, TABLE_NAME) "
+      "WHERE C.extra NOT LIKE '%VIRTUAL GENERATED%' AND C.extra NOT LIKE '%STORED GENERATED%' "
+      "ORDER BY C.TABLE_SCHEMA, C.TABLE_NAME, C.ORDINAL_POSITION";
+  MYSQL_RES *result = m_store_result(conn, query, m_warning, "Failed to prefetch selectable columns", NULL);
+  if (!result)
+    return;
+  MYSQL_ROW row;
+  gchar *cache_key = NULL;
+  GString *fields = NULL;
+  while ((row = mysql_fetch_row(result))) {
+    cache_key = g_strdup_printf("%s.%s", row[0], row[1]);
+    fields = g_hash_table_lookup(selectable_fields_cache, cache_key);
+    if (fields){
+      g_free(cache_key);
+      g_string_append_c(fields, ',');
+    }else{
+      fields = g_string_new("");
+      g_hash_table_insert(selectable_fields_cache, cache_key, fields);
+    }
+    char *field_name= identifier_quote_character_protect(row[2]);
+    g_string_append_printf(fields, "%s%s%s", identifier_quote_character_str, field_name, identifier_quote_character_str);
+    g_free(field_name);
+  }
+  mysql_free_result(result);
+  g_message("Prefetched selectable columns of %u tables", g_hash_table_size(selectable_fields_cache));
+}
+
+// Prefetch the metadata needed to discover the tables in bulk queries
 // Called once at startup when --bulk-metadata-prefetch is used
 void prefetch_table_metadata(MYSQL *conn) {
   if (metadata_prefetch_done)
     return;
 
-  g_message("Prefetching table metadata (collations, JSON fields, generated columns)...");
+  g_message("Prefetching table metadata (collations, JSON fields, generated columns, indexes, triggers)...");
   GTimer *timer = g_timer_new();
 
   // Prefetch ALL collation->charset mappings in one query
@@ -121,11 +240,43 @@ void prefetch_table_metadata(MYSQL *conn) {
     g_message("Prefetched %u tables with generated columns", generated_count);
   }
 
+  prefetch_indexes(conn);
+
+  if (!ignore_generated_fields && (complete_insert || g_hash_table_size(generated_fields_cache) > 0))
+    prefetch_selectable_fields(conn);
+
+  // Prefetch all tables with triggers - single query for ALL tables
+  const char *triggers_query =
+      "SELECT DISTINCT EVENT_OBJECT_SCHEMA, EVENT_OBJECT_TABLE FROM information_schema.TRIGGERS";
+  result = m_store_result(conn, triggers_query, m_warning, "Failed to prefetch trigger metadata", NULL);
+  if (result) {
+    MYSQL_ROW row;
+    guint triggers_count = 0;
+    while ((row = mysql_fetch_row(result))) {
+      gchar *cache_key = g_strdup_printf("%s.%s", row[0], row[1]);
+      g_hash_table_insert(triggers_cache, cache_key, GINT_TO_POINTER(1));
+      triggers_count++;
+    }
+    mysql_free_result(result);
+    triggers_prefetch_done = TRUE;
+    g_message("Prefetched %u tables with triggers", triggers_count);
+  }
+
   metadata_prefetch_done = TRUE;
   g_message("Metadata prefetch completed in %.2f seconds", g_timer_elapsed(timer, NULL));
   g_timer_destroy(timer);
 }
 
+// Returns TRUE when the prefetched catalog can tell if the table has triggers
+gboolean get_has_triggers_from_catalog(struct db_table *dbt, gboolean *has_triggers){
+  if (!triggers_prefetch_done)
+    return FALSE;
+  gchar *cache_key = g_strdup_printf("%s.%s", dbt->database->source_database, dbt->table);
+  *has_triggers = g_hash_table_contains(triggers_cache, cache_key);
+  g_free(cache_key);
+  return TRUE;
+}
+
 void free_db_table(struct db_table * dbt){
   g_mutex_lock(dbt->chunks_mutex);
   g_mutex_free(dbt->rows_lock);
@@ -178,20 +329,134 @@ gchar *get_character_set_from_collation(MYSQL *conn, gchar *collation){
   return character_set;
 }
 
+struct chunk_key_candidate{
+  gchar *column;
+  gboolean is_unique;
+  guint64 cardinality;
+};
+
 static
-void get_primary_key(MYSQL *conn, struct db_table * dbt, struct configuration *conf){
-  MYSQL_RES *indexes = NULL;
+gint compare_chunk_key_candidates(gconstpointer a, gconstpointer b){
+  const struct chunk_key_candidate *ca=a, *cb=b;
+  if (ca->is_unique != cb->is_unique)
+    return ca->is_unique ? -1 : 1;
+  if (ca->cardinality != cb->cardinality)
+    return ca->cardinality > cb->cardinality ? -1 : 1;
+  return g_strcmp0(ca->column, cb->column);
+}
+
+// The first column of every visible index, that is not the one used by
+// primary_key, is a candidate to split the table when primary_key can not be
+// used. Unique indexes go first, then by cardinality.
+static
+void get_chunk_key_candidates(GList *indexes, struct db_table * dbt){
+  gchar **row;
+  gchar *primary_key_column=dbt->primary_key?dbt->primary_key->data:NULL;
+  GList *candidates=NULL, *l;
+  for (l=indexes; l; l=l->next){
+    row=l->data;
+    if (!row[4] || strcmp(row[3], "1") || !g_strcmp0(row[4], primary_key_column))
+      continue;
+    if (row[INDEX_ROW_VISIBLE] && !g_ascii_strcasecmp(row[INDEX_ROW_VISIBLE], "NO"))
+      continue;
+    struct chunk_key_candidate *ckc=g_new0(struct chunk_key_candidate, 1);
+    ckc->is_unique= !strcmp(row[1], "0");
+    ckc->cardinality= row[6] ? strtoull(row[6], NULL, 10) : 0;
+    if (!ckc->is_unique && ckc->cardinality < num_threads){
+      g_free(ckc);
+      continue;
+    }
+    ckc->column=row[4];
+    candidates=g_list_insert_sorted(candidates, ckc, compare_chunk_key_candidates);
+  }
+  for (l=candidates; l; l=l->next){
+    struct chunk_key_candidate *ckc=l->data;
+    if (!g_list_find_custom(dbt->chunk_key_candidates, ckc->column, (GCompareFunc)g_strcmp0))
+      dbt->chunk_key_candidates=g_list_append(dbt->chunk_key_candidates, g_strdup(ckc->column));
+  }
+  g_list_free_full(candidates, g_free);
+}
+
+// MySQL 8.0.30+ might add an invisible primary key to tables created without
+// one, which is hidden from SHOW INDEX when show_gipk_in_create_table_and_information_schema=OFF.
+// The variable is only enabled for this query, as SHOW CREATE TABLE must keep
+// the generated invisible primary key hidden.
+static
+gboolean has_generated_invisible_primary_key(MYSQL *conn, struct db_table * dbt){
+  if (get_product() == SERVER_TYPE_MARIADB || get_product() == SERVER_TYPE_TIDB || get_major() < 8 ||
+      (get_major() == 8 && get_secondary() == 0 && get_revision() < 30))
+    return FALSE;
+  struct M_ROW *mr = m_store_result_row(conn, "SELECT @@show_gipk_in_create_table_and_information_schema", NULL, NULL, NULL);
+  gboolean shown = mr->row && mr->row[0] && !strcmp(mr->row[0], "1");
+  gboolean supported = mr->row != NULL;
+  m_store_result_row_free(mr);
+  if (!supported)
+    return FALSE;
+  if (!shown && m_query(conn, "SET SESSION show_gipk_in_create_table_and_information_schema=ON", NULL, NULL))
+    return FALSE;
+  gchar *query = g_strdup_printf("SELECT 1 FROM information_schema.COLUMNS C JOIN information_schema.STATISTICS S "
+                        "ON S.TABLE_SCHEMA=C.TABLE_SCHEMA AND S.TABLE_NAME=C.TABLE_NAME AND S.COLUMN_NAME=C.COLUMN_NAME "
+                        "WHERE C.TABLE_SCHEMA='%s' AND C.TABLE_NAME='%s' AND C.COLUMN_NAME='%s' "
+                        "AND C.EXTRA LIKE '%%INVISIBLE%%' AND S.INDEX_NAME='PRIMARY'",
+                        dbt->database->source_database_escaped, dbt->escaped_table, GIPK_COLUMN);
+  mr = m_store_result_row(conn, query, m_warning, NULL, "Failed to check the generated invisible primary key of %s.%s", dbt->database->source_database, dbt->table);
+  g_free(query);
+  gboolean r = mr->row != NULL;
+  m_store_result_row_free(mr);
+  if (!shown)
+    m_query(conn, "SET SESSION show_gipk_in_create_table_and_information_schema=OFF", m_warning, "Failed to hide the generated invisible primary keys");
+  return r;
+}
+
+// Copies SHOW INDEX into index rows, so it can be used as the prefetched ones
+static
+GList *get_index_rows(MYSQL *conn, struct db_table * dbt){
+  gchar *query = g_strdup_printf("SHOW INDEX FROM %s%s%s.%s%s%s",
+                        identifier_quote_character_str, dbt->database->source_database, identifier_quote_character_str, identifier_quote_character_str, dbt->table, identifier_quote_character_str);
+  MYSQL_RES *indexes = m_store_result(conn, query, m_warning, "Failed to execute SHOW INDEX over %s", dbt->database->source_database);
+  g_free(query);
+  if (!indexes)
+    return NULL;
+  MYSQL_FIELD *fields = mysql_fetch_fields(indexes);
+  guint i, visible_col=0;
+  for (i=0; i<mysql_num_fields(indexes); i++)
+    if (!g_ascii_strcasecmp(fields[i].name, "Visible"))
+      visible_col=i;
   MYSQL_ROW row;
+  GList *rows=NULL;
+  while ((row = mysql_fetch_row(indexes))) {
+    gchar **index_row = g_new0(gchar *, INDEX_ROW_FIELDS);
+    for (i=0; i<INDEX_ROW_VISIBLE; i++)
+      index_row[i] = g_strdup(row[i]);
+    if (visible_col)
+      index_row[INDEX_ROW_VISIBLE] = g_strdup(row[visible_col]);
+    rows = g_list_prepend(rows, index_row);
+  }
+  mysql_free_result(indexes);
+  return g_list_reverse(rows);
+}
+
+static
+void get_primary_key(MYSQL *conn, struct db_table * dbt, struct configuration *conf){
+  GList *indexes = NULL, *l;
+  gboolean free_indexes = TRUE;
+  gchar **row;
   dbt->primary_key=NULL;
+  dbt->chunk_key_candidates=NULL;
   // first have to pick index, in future should be able to preset in
   //    * configuration too
-  gchar *query = g_strdup_printf("SHOW INDEX FROM %s%s%s.%s%s%s",
-                        identifier_quote_character_str, dbt->database->source_database, identifier_quote_character_str, identifier_quote_character_str, dbt->table, identifier_quote_character_str);
-  indexes = m_store_result(conn, query, m_warning, "Failed to execute SHOW INDEX over %s", dbt->database->source_database);
-  g_free(query);
+  if (indexes_prefetch_done){
+    // Tables without indexes are not in the catalog
+    gchar *cache_key = g_strdup_printf("%s.%s", dbt->database->source_database, dbt->table);
+    indexes = g_hash_table_lookup(index_cache, cache_key);
+    g_free(cache_key);
+    free_indexes = FALSE;
+  }else
+    indexes = get_index_rows(conn, dbt);
 
   if (indexes){
-    while ((row = mysql_fetch_row(indexes))) {
+    for (l=indexes; l; l=l->next) {
+      row=l->data;
       if (!strcmp(row[2], "PRIMARY") ) {
         // Pick first column in PK, cardinality doesn't matter
         dbt->primary_key=g_list_append(dbt->primary_key,g_strdup(row[4]));
@@ -200,13 +465,19 @@ void get_primary_key(MYSQL *conn, struct db_table * dbt, struct configuration *c
     if (dbt->primary_key)
       goto cleanup;
 
-    // If no PK found, try using first UNIQUE index
-    mysql_data_seek(indexes, 0);
-    while ((row = mysql_fetch_row(indexes))) {
-      if (!strcmp(row[1], "0")) {
-        // Again, first column of any unique index
+    // If no PK found, try using a UNIQUE index. SHOW INDEX and the
+    // prefetched indexes list them in different order, so the one with the
+    // lowest name is used
+    const gchar *unique_index=NULL;
+    for (l=indexes; l; l=l->next) {
+      row=l->data;
+      if (!strcmp(row[1], "0") && (!unique_index || strcmp(row[2], unique_index) < 0))
+        unique_index=row[2];
+    }
+    for (l=indexes; unique_index && l; l=l->next) {
+      row=l->data;
+      if (!strcmp(row[2], unique_index))
         dbt->primary_key=g_list_append(dbt->primary_key,g_strdup(row[4]));
-      }
     }
 
     if (dbt->primary_key)
@@ -217,25 +488,32 @@ void get_primary_key(MYSQL *conn, struct db_table * dbt, struct configuration *c
       guint64 max_cardinality = 0;
       guint64 cardinality = 0;
       gchar *field=NULL;
-      mysql_data_seek(indexes, 0);
-      while ((row = mysql_fetch_row(indexes))) {
+      for (l=indexes; l; l=l->next) {
+        row=l->data;
         if (!strcmp(row[3], "1")) {
           if (row[6])
             cardinality = strtoul(row[6], NULL, 10);
-          if (cardinality > max_cardinality) {
-            field = g_strdup(row[4]);
+          // Ties are broken by column name, to not depend on the index order
+          if (cardinality > max_cardinality ||
+              (field && cardinality == max_cardinality && g_strcmp0(row[4], field) < 0)) {
+            field = row[4];
             max_cardinality = cardinality;
           }
         }
       }
       if (field)
-        dbt->primary_key=g_list_append(dbt->primary_key,field);
+        dbt->primary_key=g_list_append(dbt->primary_key,g_strdup(field));
     }
   }
 
 cleanup:
-  if (indexes)
-    mysql_free_result(indexes);
+  if (indexes){
+    get_chunk_key_candidates(indexes, dbt);
+    if (free_indexes)
+      free_index_rows(indexes);
+  }
+  if (!dbt->primary_key && !dbt->chunk_key_candidates && has_generated_invisible_primary_key(conn, dbt))
+    dbt->chunk_key_candidates=g_list_append(NULL, g_strdup(GIPK_COLUMN));
 }
 
 static
@@ -263,6 +541,15 @@ static
 GString *get_selectable_fields(MYSQL *conn, char *database, char *table) {
   MYSQL_ROW row;
 
+  // Use prefetched cache if available (--bulk-metadata-prefetch)
+  if (metadata_prefetch_done) {
+    gchar *cache_key = g_strdup_printf("%s.%s", database, table);
+    GString *fields = g_hash_table_lookup(selectable_fields_cache, cache_key);
+    g_free(cache_key);
+    if (fields)
+      return g_string_new(fields->str);
+  }
+
   GString *field_list = g_string_new("");
 
   gchar *query =
@@ -402,12 +689,21 @@ gboolean new_db_table(struct db_table **d, MYSQL *conn, struct configuration *co
     dbt->has_json_fields = has_json_fields(conn, dbt->database->source_database, dbt->table);
     dbt->rows_lock= g_mutex_new();
     dbt->rows_total=0;
+    dbt->data_length=0;
+    dbt->coalesce=FALSE;
     dbt->escaped_table = escape_string(conn,dbt->table);
     dbt->where=m_coalesce_hash(g_hash_table_lookup(conf_per_table,WHERE), config_file_dbt_key, any_db_config_file_dbt_key, any_table_config_file_dbt_key);
     dbt->limit=m_coalesce_hash(g_hash_table_lookup(conf_per_table,LIMIT), config_file_dbt_key, any_db_config_file_dbt_key, any_table_config_file_dbt_key);
     parse_object_scope(&(dbt->object_to_export), m_coalesce_hash(g_hash_table_lookup(conf_per_table,OBJECT_TO_EXPORT), config_file_dbt_key, any_db_config_file_dbt_key, any_table_config_file_dbt_key));
 
     dbt->partition_regex=m_coalesce_hash(g_hash_table_lookup(conf_per_table, PARTITION_REGEX), config_file_dbt_key, any_db_config_file_dbt_key, any_table_config_file_dbt_key);
+    // The masquerade functions are applied by mydumper on each row, so the
+    // data can't be written by the server
+    GHashTable *anonymized_function_per_table=g_hash_table_lookup(conf_per_table, ANONYMIZED_FUNCTION);
+    GHashTable *anonymized_function=anonymized_function_per_table?g_hash_table_lookup(anonymized_function_per_table, config_file_dbt_key):NULL;
+    dbt->has_anonymized_function=anonymized_function && g_hash_table_size(anonymized_function) > 0;
+    // The tablespace has all the rows unmasked, so it can't be used when they are filtered or masqueraded
+    dbt->transportable_tablespace= !dbt->object_to_export.no_data && !where_option && !dbt->where && !dbt->limit && !dbt->partition_regex && !dbt->has_anonymized_function && is_transportable_table(dbt);
     dbt->max_threads_per_table=max_threads_per_table;
     dbt->current_threads_running=0;
 
@@ -448,6 +744,7 @@ gboolean new_db_table(struct db_table **d, MYSQL *conn, struct configuration *co
     dbt->chunks=NULL;
     dbt->load_data_header=NULL;
     dbt->load_data_suffix=NULL;
+    dbt->outfile_fields=NULL;
     dbt->insert_statement=NULL;
     dbt->chunks_mutex=g_mutex_new();
     dbt->write_mutex=g_mutex_new();
@@ -18,6 +18,8 @@
 
 #ifndef _src_mydumper_table_h
 #define _src_mydumper_table_h
+// Column name of the MySQL generated invisible primary key
+#define GIPK_COLUMN "my_row_id"
 #include "mydumper_start_dump.h"
 enum db_table_states{
   UNDEFINED,
@@ -40,12 +42,17 @@ struct db_table {
   GString *insert_statement;
   GString *load_data_header;
   GString *load_data_suffix;
+  GString *outfile_fields;
   gboolean is_transactional;
   gboolean is_sequence;
   gboolean is_view;
   gboolean has_json_fields;
+  gboolean has_anonymized_function;
+  gboolean coalesce;
+  gboolean transportable_tablespace;
   char *character_set;
   guint64 rows_total;
+  guint64 data_length;
   guint64 rows;
   guint64 estimated_remaining_steps;
   GMutex *rows_lock;
@@ -61,6 +68,7 @@ struct db_table {
   GMutex *write_mutex;
   GAsyncQueue *chunks_queue;
   GList *primary_key;
+  GList *chunk_key_candidates;
   gchar *primary_key_separated_by_comma;
   gboolean multicolumn;
   gint * chunks_completed;
@@ -80,6 +88,7 @@ struct db_table {
 void initialize_table();
 void finalize_table();
 void prefetch_table_metadata(MYSQL *conn);
+gboolean get_has_triggers_from_catalog(struct db_table *dbt, gboolean *has_triggers);
 void free_db_table(struct db_table * dbt);
 gboolean new_db_table(struct db_table **d, MYSQL *conn, struct configuration *conf,
                       struct database *database, char *table, char *table_collation,
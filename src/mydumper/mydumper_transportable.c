@@ -0,0 +1,248 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+        Authors:    David Ducos, Percona (david dot ducos at percona dot com)
+*/
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <gio/gio.h>
+#include <string.h>
+
+#include "mydumper.h"
+#include "mydumper_global.h"
+#include "mydumper_common.h"
+#include "mydumper_database.h"
+#include "mydumper_transportable.h"
+
+guint transportable_tablespace_size=0;
+
+struct transportable_table {
+  gchar *database;
+  gchar *table;
+  struct db_table *dbt;
+};
+
+static GHashTable *transportable_tables=NULL;
+static GMutex *transportable_tables_mutex=NULL;
+static MYSQL *export_conn=NULL;
+static gchar *source_datadir=NULL;
+static GThread *copy_thread=NULL;
+
+// The file of the tablespace is <datadir>/<database>/<table>.ibd only when
+// the names don't need to be encoded by the server
+static
+gboolean is_plain_name(const gchar *name){
+  const gchar *c=name;
+  for (; *c; c++)
+    if (!g_ascii_isalnum(*c) && *c != '_')
+      return FALSE;
+  return c != name;
+}
+
+static
+gchar *build_source_tablespace_filename(struct transportable_table *tt, const gchar *extension){
+  gchar *filename=g_strdup_printf("%s.%s", tt->table, extension);
+  gchar *r=g_build_filename(source_datadir, tt->database, filename, NULL);
+  g_free(filename);
+  return r;
+}
+
+static
+gchar *build_tablespace_dump_filename(struct db_table *dbt, const gchar *extension){
+  gchar *filename=g_strdup_printf("%s.%s.%s", dbt->database->database_name_in_filename, dbt->table_filename, extension);
+  gchar *r=g_build_filename(dump_directory, filename, NULL);
+  g_free(filename);
+  return r;
+}
+
+static
+void free_transportable_table(struct transportable_table *tt){
+  g_free(tt->database);
+  g_free(tt->table);
+  g_free(tt);
+}
+
+static
+GList *get_transportable_candidates(MYSQL *conn){
+  GList *candidates=NULL;
+  gchar **db_items=source_db?g_strsplit(source_db,",",0):NULL;
+  gchar *query=g_strdup_printf(
+    "SELECT TABLE_SCHEMA, TABLE_NAME FROM information_schema.TABLES "
+    "WHERE ENGINE='InnoDB' AND TABLE_TYPE='BASE TABLE' AND CREATE_OPTIONS NOT LIKE '%%partitioned%%' "
+    "AND DATA_LENGTH+INDEX_LENGTH >= %"G_GUINT64_FORMAT" AND TABLE_SCHEMA NOT IN "
+    "('mysql', 'sys', 'information_schema', 'performance_schema')",
+    (guint64)transportable_tablespace_size*1024*1024);
+  MYSQL_RES *res=m_store_result(conn, query, m_warning, "Not able to get the tables for transportable tablespaces", NULL);
+  MYSQL_ROW row;
+  g_free(query);
+  if (res){
+    while ((row = mysql_fetch_row(res))) {
+      if (db_items && !g_strv_contains((const gchar * const *)db_items, row[0]))
+        continue;
+      if (tables_skiplist_file && check_skiplist(row[0], row[1]))
+        continue;
+      if (is_mysql_special_tables(row[0], row[1]) || !eval_regex(row[0], row[1]))
+        continue;
+      if (!is_plain_name(row[0]) || !is_plain_name(row[1])){
+        g_message("Dumping `%s`.`%s` as rows as its name is not supported by transportable tablespaces", row[0], row[1]);
+        continue;
+      }
+      struct transportable_table *tt=g_new0(struct transportable_table, 1);
+      tt->database=g_strdup(row[0]);
+      tt->table=g_strdup(row[1]);
+      candidates=g_list_prepend(candidates, tt);
+    }
+    mysql_free_result(res);
+  }
+  g_strfreev(db_items);
+  return g_list_reverse(candidates);
+}
+
+// It must be called while the global lock is held, so the tablespaces are
+// consistent with the snapshot of the rest of the tables
+void start_transportable_tablespaces(MYSQL *conn){
+  transportable_tables=g_hash_table_new_full(g_str_hash, g_str_equal, &g_free, (GDestroyNotify) &free_transportable_table);
+  transportable_tables_mutex=g_mutex_new();
+
+  if (datadir){
+    source_datadir=g_strdup(datadir);
+  }else{
+    MYSQL_RES *res=m_store_result(conn, "SELECT @@datadir", m_warning, "Not able to get @@datadir", NULL);
+    MYSQL_ROW row;
+    if (res && (row=mysql_fetch_row(res)) && row[0])
+      source_datadir=g_strdup(row[0]);
+    if (res)
+      mysql_free_result(res);
+  }
+  if (!source_datadir || !g_file_test(source_datadir, G_FILE_TEST_IS_DIR)){
+    g_warning("Datadir %s is not accessible, transportable tablespaces disabled. Use --datadir if mydumper runs on the database host", source_datadir?source_datadir:"");
+    return;
+  }
+
+  GList *candidates=get_transportable_candidates(conn);
+  if (candidates == NULL)
+    return;
+
+  GString *query=g_string_new("FLUSH TABLES ");
+  GList *l=candidates;
+  for (; l; l=l->next){
+    struct transportable_table *tt=l->data;
+    g_string_append_printf(query, "%s%s%s.%s%s%s%s", l==candidates?"":",",
+                           identifier_quote_character_str, tt->database, identifier_quote_character_str,
+                           identifier_quote_character_str, tt->table, identifier_quote_character_str);
+  }
+  g_string_append(query, " FOR EXPORT");
+
+  // The tables stay locked for export until this connection runs UNLOCK TABLES
+  export_conn=mysql_init(NULL);
+  m_connect(export_conn);
+  execute_gstring(export_conn, set_session);
+  g_message("Flushing %u tables for export", g_list_length(candidates));
+  if (m_query_warning(export_conn, query->str, "Not able to flush the tables for export, they will be dumped as rows", NULL)){
+    mysql_close(export_conn);
+    export_conn=NULL;
+    g_list_free_full(candidates, (GDestroyNotify) &free_transportable_table);
+    g_string_free(query, TRUE);
+    return;
+  }
+  g_string_free(query, TRUE);
+
+  for (l=candidates; l; l=l->next){
+    struct transportable_table *tt=l->data;
+    gchar *ibd=build_source_tablespace_filename(tt, "ibd");
+    // Tables in the system or general tablespaces have no file of their own
+    if (g_file_test(ibd, G_FILE_TEST_IS_REGULAR)){
+      g_hash_table_insert(transportable_tables, build_dbt_key(tt->database, tt->table), tt);
+    }else{
+      trace("Tablespace file %s not found, `%s`.`%s` will be dumped as rows", ibd, tt->database, tt->table);
+      free_transportable_table(tt);
+    }
+    g_free(ibd);
+  }
+  g_list_free(candidates);
+  g_message("%u tables will be dumped as transportable tablespaces", g_hash_table_size(transportable_tables));
+}
+
+gboolean is_transportable_table(struct db_table *dbt){
+  if (transportable_tables == NULL)
+    return FALSE;
+  gchar *key=build_dbt_key(dbt->database->source_database, dbt->table);
+  g_mutex_lock(transportable_tables_mutex);
+  struct transportable_table *tt=g_hash_table_lookup(transportable_tables, key);
+  if (tt)
+    tt->dbt=dbt;
+  g_mutex_unlock(transportable_tables_mutex);
+  g_free(key);
+  return tt != NULL;
+}
+
+static
+gboolean copy_tablespace_file(const gchar *source, const gchar *destination){
+  GFile *s=g_file_new_for_path(source), *d=g_file_new_for_path(destination);
+  GError *error=NULL;
+  gboolean r=g_file_copy(s, d, G_FILE_COPY_OVERWRITE, NULL, NULL, NULL, &error);
+  if (!r){
+    g_critical("Not able to copy %s to %s: %s", source, destination, error->message);
+    g_error_free(error);
+  }
+  g_object_unref(s);
+  g_object_unref(d);
+  return r;
+}
+
+static
+void *copy_tablespaces_thread(void *data){
+  (void) data;
+  GHashTableIter iter;
+  struct transportable_table *tt=NULL;
+  gchar *source=NULL, *destination=NULL;
+  g_hash_table_iter_init(&iter, transportable_tables);
+  while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &tt)){
+    // Tables that were filtered out never got a dbt
+    if (tt->dbt == NULL)
+      continue;
+    g_message("Copying tablespace of `%s`.`%s`", tt->database, tt->table);
+    source=build_source_tablespace_filename(tt, "ibd");
+    destination=build_tablespace_dump_filename(tt->dbt, "ibd");
+    if (!copy_tablespace_file(source, destination))
+      errors++;
+    g_free(source);
+    g_free(destination);
+    source=build_source_tablespace_filename(tt, "cfg");
+    destination=build_tablespace_dump_filename(tt->dbt, "cfg");
+    if (!copy_tablespace_file(source, destination))
+      errors++;
+    g_free(source);
+    g_free(destination);
+  }
+  m_query_warning(export_conn, "UNLOCK TABLES", "Not able to unlock the tables flushed for export", NULL);
+  mysql_close(export_conn);
+  export_conn=NULL;
+  return NULL;
+}
+
+// All the dbts must exist before the copy starts
+void start_copy_tablespaces(){
+  if (export_conn == NULL)
+    return;
+  copy_thread=m_thread_new("tablespace", copy_tablespaces_thread, NULL, "Tablespace copy thread could not be created");
+}
+
+void wait_copy_tablespaces(){
+  if (copy_thread){
+    g_thread_join(copy_thread);
+    copy_thread=NULL;
+  }
+}
@@ -35,6 +35,7 @@
 #include "mydumper_create_jobs.h"
 #include "mydumper_working_thread.h"
 #include "mydumper_table.h"
+#include "mydumper_write.h"
 /* Program options */
 gboolean order_by_primary_key = FALSE;
 gboolean use_savepoints = FALSE;
@@ -175,12 +176,18 @@ void start_working_thread(struct configuration *conf ){
     thread_data[n].table_name=NULL;
     thread_data[n].local_row_count = 0;
     thread_data[n].local_row_count_dbt = NULL;
+    thread_data[n].async_writer = NULL;
+    thread_data[n].buffers_memory = 0;
+    thread_data[n].bundle = NULL;
     thread_data[n].thread_data_buffers.statement = g_string_sized_new(2*statement_size);
     thread_data[n].thread_data_buffers.row = g_string_sized_new(statement_size);
     thread_data[n].thread_data_buffers.column = g_string_sized_new(statement_size);
     thread_data[n].thread_data_buffers.escaped = g_string_sized_new(statement_size);
     thread_data[n].thread_data_buffers.target_column = thread_data[n].thread_data_buffers.column;
     thread_data[n].thread_data_buffers.column_mask = g_string_sized_new(statement_size);
+    if (async_write)
+      initialize_async_writer(&thread_data[n]);
+    account_thread_buffers(&thread_data[n]);
     threads[n] =
         m_thread_new("data", (GThreadFunc)working_thread, &thread_data[n], "Data thread could not be created");
   }
@@ -312,8 +319,8 @@ void get_table_info_to_process_from_list(MYSQL *conn, struct configuration *conf
       return;
     }
 
-    guint ecol = -1, ccol = -1, collcol = -1, rowscol = 0;
-    determine_show_table_status_columns(result, &ecol, &ccol, &collcol, &rowscol);
+    guint ecol = -1, ccol = -1, collcol = -1, rowscol = 0, dlcol = 0;
+    determine_show_table_status_columns(result, &ecol, &ccol, &collcol, &rowscol, &dlcol);
     struct database * database=get_database(conn, dt[0], TRUE);
 /*    if (get_database(conn, dt[0], &database)){
       if (!database->already_dumped){
@@ -360,7 +367,8 @@ void get_table_info_to_process_from_list(MYSQL *conn, struct configuration *conf
       if (!eval_regex(database->source_database, row[0]))
         continue;
 
-      create_job_to_dump_table(is_view, is_sequence, database, g_strdup(row[tablecol]), g_strdup(row[collcol]), g_strdup(row[ecol]));
+      create_job_to_dump_table(is_view, is_sequence, database, g_strdup(row[tablecol]), g_strdup(row[collcol]), g_strdup(row[ecol]),
+                             dlcol > 0 && row[dlcol] ? g_ascii_strtoull(row[dlcol], NULL, 10) : 0);
     }
     mysql_free_result(result);
     g_strfreev(dt);
@@ -424,6 +432,7 @@ void thd_JOB_DUMP(struct thread_data *td, struct job *job){
   g_mutex_lock(tj->dbt->chunks_mutex);
   tj->dbt->current_threads_running--;
   g_mutex_unlock(tj->dbt->chunks_mutex);
+  notify_chunk_builder();
 
   free_table_job(tj);
   g_free(job);
@@ -724,6 +733,7 @@ gboolean process_job(struct thread_data *td, struct job *job){
       g_mutex_lock(dbt->chunks_mutex);
       dbt->current_threads_running--;
       g_mutex_unlock(dbt->chunks_mutex);
+      notify_chunk_builder();
       g_free(job);
       break;
     }
@@ -981,6 +991,7 @@ void *working_thread(struct thread_data *td) {
     }
     process_queue(td->conf->transactional.queue, td, FALSE, td->conf->transactional.request_chunk);
     process_queue(td->conf->transactional.defer, td, FALSE, NULL);
+    close_bundle(td);
   }else{
     g_async_queue_push(td->conf->unlock_tables, GINT_TO_POINTER(1));
   }
@@ -1019,6 +1030,8 @@ void *working_thread(struct thread_data *td) {
   if (td->binlog_snapshot_gtid_executed!=NULL)
     g_free(td->binlog_snapshot_gtid_executed);
 
+  finalize_async_writer(td);
+
   if (td->thrconn)
     mysql_close(td->thrconn);
   mysql_thread_end();
@@ -1028,11 +1041,12 @@ void *working_thread(struct thread_data *td) {
 static
 void new_table_to_dump(MYSQL *conn, struct configuration *conf, gboolean is_view,
                        gboolean is_sequence, struct database * database, char *table,
-                       char *collation, gchar *ecol)
+                       char *collation, gchar *ecol, guint64 data_length)
 {
   struct db_table *dbt=NULL;
   gboolean b= new_db_table(&dbt, conn, conf, database, table, collation, is_sequence, is_view);
   if (b){
+    dbt->data_length=data_length;
   // if a view or sequence we care only about schema
     if (is_sequence){
       if (!no_schemas && !dbt->object_to_export.no_schema) {
@@ -1062,10 +1076,14 @@ void new_table_to_dump(MYSQL *conn, struct configuration *conf, gboolean is_view
       }
       if (!no_data && !dbt->object_to_export.no_data) {
         if (ecol != NULL && g_ascii_strcasecmp("MRG_MYISAM",ecol)) {
+          dbt->coalesce= coalesce_tables > 0 && data_length < (guint64)coalesce_tables*1024*1024;
           if (!dbt->checksum.skip_data && !( get_major() == 5 && get_secondary() == 7 && dbt->has_json_fields ) ){
             create_job_to_dump_checksum(dbt);
           }
-          if (trx_tables ||
+          if (dbt->transportable_tablespace){
+            // The rows are in the tablespace files copied by the main thread
+            dbt->is_transactional=TRUE;
+          } else if (trx_tables ||
             (ecol != NULL && (!g_ascii_strcasecmp("InnoDB", ecol) || !g_ascii_strcasecmp("TokuDB", ecol)))) {
             dbt->is_transactional=TRUE;
             g_mutex_lock(transactional_table->mutex);
@@ -1163,8 +1181,8 @@ void dump_database_thread(MYSQL *conn, struct database *database) {
   if (!result)
     return;
 
-  guint ecol= -1, ccol= -1, collcol= -1, rowscol= 0;
-  determine_show_table_status_columns(result, &ecol, &ccol, &collcol, &rowscol);
+  guint ecol= -1, ccol= -1, collcol= -1, rowscol= 0, dlcol= 0;
+  determine_show_table_status_columns(result, &ecol, &ccol, &collcol, &rowscol, &dlcol);
 
   MYSQL_ROW row;
   while ((row = mysql_fetch_row(result))) {
@@ -1269,7 +1287,8 @@ void dump_database_thread(MYSQL *conn, struct database *database) {
       dump_summary_note_skipped();
       continue;
     }
-    create_job_to_dump_table(is_view, is_sequence, database, g_strdup(row[tablecol]), g_strdup(row[collcol]), g_strdup(row[ecol]));
+    create_job_to_dump_table(is_view, is_sequence, database, g_strdup(row[tablecol]), g_strdup(row[collcol]), g_strdup(row[ecol]),
+                             dlcol > 0 && row[dlcol] ? g_ascii_strtoull(row[dlcol], NULL, 10) : 0);
   }
 
   mysql_free_result(result);
@@ -1287,7 +1306,7 @@ static
 void thd_JOB_TABLE(struct thread_data *td, struct job *job){
   struct dump_table_job *dtj=(struct dump_table_job *)job->job_data;
   new_table_to_dump(td->thrconn, td->conf, dtj->is_view, dtj->is_sequence, dtj->database, dtj->table,
-                      dtj->collation, dtj->engine);
+                      dtj->collation, dtj->engine, dtj->data_length);
   free(dtj->collation);
   free(dtj->engine);
   free(dtj);
@@ -37,6 +37,8 @@ struct thread_data_buffers {
   GString *target_column;
 };
 
+struct async_writer;
+
 struct thread_data {
   struct configuration *conf;
   guint thread_id;
@@ -48,6 +50,12 @@ struct thread_data {
   // Thread-local row counter for batched updates (reduces atomic ops 1000x)
   guint64 local_row_count;
   struct db_table *local_row_count_dbt;
+  // Only used with --async-write
+  struct async_writer *async_writer;
+  // Bytes of thread_data_buffers accounted on the memory budget
+  guint64 buffers_memory;
+  // Only used with --coalesce-tables
+  struct bundle *bundle;
 };
 
 #endif
@@ -22,6 +22,8 @@
 #include <glib/gstdio.h>
 #include <math.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 
 #include "mydumper.h"
 #include "mydumper_start_dump.h"
@@ -34,6 +36,7 @@
 #include "mydumper_global.h"
 #include "mydumper_arguments.h"
 #include "mydumper_file_handler.h"
+#include "mydumper_stream.h"
 
 /* Some earlier versions of MySQL do not yet define MYSQL_TYPE_JSON */
 #ifndef MYSQL_TYPE_JSON
@@ -56,6 +59,8 @@ gboolean load_data = FALSE;
 gboolean csv = FALSE;
 gboolean clickhouse = FALSE;
 gboolean include_header = FALSE;
+gboolean server_outfile = FALSE;
+gchar *secure_file_priv = NULL;
 const gchar *fields_enclosed_by=NULL;
 gchar *fields_escaped_by=NULL;
 gchar *fields_terminated_by=NULL;
@@ -72,6 +77,30 @@ gboolean insert_ignore = FALSE;
 gboolean replace = FALSE;
 gboolean hex_blob = FALSE;
 
+// --max-memory accounting of the thread buffers, see account_thread_buffers()
+#define THREAD_BUFFERS_BASE_SIZE (6 * statement_size)
+#define THREAD_BUFFERS_RELEASED_SIZE (2 * THREAD_BUFFERS_BASE_SIZE)
+
+static GMutex *memory_budget_mutex = NULL;
+static GCond *memory_budget_cond = NULL;
+static guint64 buffers_memory = 0;
+static guint64 buffers_extra_memory = 0;
+
+// --coalesce-tables: each thread appends the data of the small tables that it
+// dumps into its current bundle, one segment per data file that the table
+// would have had. The index of the segments is written at the end of the
+// bundle, followed by a fixed size line with the offset of the index.
+#define BUNDLE_MAX_SIZE (64 * 1024 * 1024)
+
+struct bundle{
+  int file;
+  gchar *filename;
+  guint number;
+  guint64 segment_offset;
+  GString *index;
+  GList *dbts;
+};
+
 static void emit_dump_write_event(GLogLevelFlags level, const gchar *message,
                                   const gchar *status, struct table_job *tj,
                                   const gchar *filename, gint saved_errno) {
@@ -101,11 +130,80 @@ static void emit_dump_write_event(GLogLevelFlags level, const gchar *message,
   g_free(errno_text);
 }
 
+static
+void open_bundle_segment(struct table_job *tj){
+  struct thread_data *td=tj->td;
+  if (td->bundle==NULL){
+    td->bundle=g_new0(struct bundle, 1);
+    td->bundle->file=-1;
+  }
+  struct bundle *b=td->bundle;
+  if (b->file < 0){
+    b->filename=build_bundle_filename(td->thread_id, b->number);
+    b->file=m_open(&(b->filename),"w");
+    b->index=g_string_new(BUNDLE_INDEX_HEADER);
+    b->number++;
+  }
+  b->segment_offset=lseek(b->file, 0, SEEK_CUR);
+  tj->rows->file=b->file;
+  tj->rows->filename=g_strdup(b->filename);
+  trace("Thread %d: Segment of `%s`.`%s` assigned at %"G_GUINT64_FORMAT": %s", td->thread_id, tj->dbt->database->source_database, tj->dbt->table, b->segment_offset, b->filename);
+}
+
+void close_bundle(struct thread_data *td){
+  struct bundle *b=td->bundle;
+  if (b==NULL || b->file < 0)
+    return;
+  guint64 size=lseek(b->file, 0, SEEK_END);
+  if (b->dbts!=NULL){
+    g_string_append_printf(b->index, "%s%020"G_GUINT64_FORMAT"\n", BUNDLE_INDEX_TRAILER, size);
+    if (!write_data(b->file, b->index))
+      g_critical("Thread %d: Could not write the index of %s", td->thread_id, b->filename);
+    size+=b->index->len;
+  }else
+    size=0;
+  m_close(td->thread_id, b->file, b->filename, size, NULL);
+  GList *l=b->dbts;
+  for (; stream && l!=NULL; l=l->next)
+    metadata_partial_queue_push(l->data);
+  g_list_free(b->dbts);
+  b->dbts=NULL;
+  g_string_free(b->index, TRUE);
+  b->index=NULL;
+  g_free(b->filename);
+  b->filename=NULL;
+  b->file=-1;
+}
+
+void close_bundle_segment(struct table_job *tj){
+  struct bundle *b=tj->td->bundle;
+  wait_table_job_writes(tj);
+  guint64 end=lseek(b->file, 0, SEEK_CUR);
+  if (end > b->segment_offset){
+    gchar *filename=build_sql_filename(tj->dbt->database->database_name_in_filename, tj->dbt->table_filename, tj->part, tj->sub_part);
+    gchar *basename=g_path_get_basename(filename);
+    g_string_append_printf(b->index, "-- %"G_GUINT64_FORMAT" %"G_GUINT64_FORMAT" %s\n", b->segment_offset, end - b->segment_offset, basename);
+    g_free(basename);
+    g_free(filename);
+    if (!g_list_find(b->dbts, tj->dbt))
+      b->dbts=g_list_prepend(b->dbts, tj->dbt);
+  }
+  tj->rows->file=-1;
+  g_free(tj->rows->filename);
+  tj->rows->filename=NULL;
+  if (end >= BUNDLE_MAX_SIZE)
+    close_bundle(tj->td);
+}
+
 static
 gboolean update_files_on_table_job(struct table_job *tj)
 {
   if (tj->rows->file < 0){
     g_assert(tj->rows->filename==NULL);    
+    if (tj->dbt->coalesce){
+      open_bundle_segment(tj);
+      return FALSE;
+    }
     tj->rows->filename = build_rows_filename(tj->dbt->database->database_name_in_filename, tj->dbt->table_filename, tj->part, tj->sub_part);
     tj->rows->file = m_open(&(tj->rows->filename),"w");
     trace("Thread %d: Filename assigned(%d): %s", tj->td->thread_id, tj->rows->file, tj->rows->filename);
@@ -248,6 +346,10 @@ void initialize_write(){
     m_critical("--fields-escaped-by must be a single character");
 
   max_statement_size_mutex=g_mutex_new();
+  memory_budget_mutex=g_mutex_new();
+  memory_budget_cond=g_cond_new();
+  if (max_memory > 0 && (guint64)max_memory * 1024 * 1024 < (guint64)THREAD_BUFFERS_BASE_SIZE * num_threads)
+    g_warning("--max-memory is lower than the %u MB that the threads need at start", (guint)(((guint64)THREAD_BUFFERS_BASE_SIZE * num_threads) >> 20));
 
   switch (output_format){
 		case CLICKHOUSE:
@@ -512,22 +614,28 @@ gboolean write_data(int file, GString *data) {
   return real_write_data(file, &f, data);
 }
 
-void initialize_load_data_statement_suffix(struct db_table *dbt, MYSQL_FIELD * fields, guint num_fields){
-//  gchar *character_set=set_names_in_conn_by_default != NULL ? set_names_in_conn_by_default : dbt->character_set /* "BINARY"*/;
-  GString *load_data_suffix=g_string_sized_new(statement_size);
-  g_string_append_printf(load_data_suffix, "%s' INTO TABLE %s%s%s ", exec_per_thread_extension, identifier_quote_character_str, dbt->table, identifier_quote_character_str);
+// The same clauses are used by LOAD DATA and by SELECT ... INTO OUTFILE
+static
+void append_load_data_format(GString *statement){
   if (load_data_character_set)
-    g_string_append_printf(load_data_suffix, "CHARACTER SET %s ",load_data_character_set);
+    g_string_append_printf(statement, "CHARACTER SET %s ",load_data_character_set);
   if (fields_terminated_by_ld)
-    g_string_append_printf(load_data_suffix, "FIELDS TERMINATED BY '%s' ",fields_terminated_by_ld);
+    g_string_append_printf(statement, "FIELDS TERMINATED BY '%s' ",fields_terminated_by_ld);
   if (fields_enclosed_by_ld)
-    g_string_append_printf(load_data_suffix, "ENCLOSED BY '%s' ",fields_enclosed_by_ld);
+    g_string_append_printf(statement, "ENCLOSED BY '%s' ",fields_enclosed_by_ld);
   if (fields_escaped_by)
-    g_string_append_printf(load_data_suffix, "ESCAPED BY '%s' ",fields_escaped_by);
-  g_string_append(load_data_suffix, "LINES ");
+    g_string_append_printf(statement, "ESCAPED BY '%s' ",fields_escaped_by);
+  g_string_append(statement, "LINES ");
   if (lines_starting_by_ld)
-    g_string_append_printf(load_data_suffix, "STARTING BY '%s' ",lines_starting_by_ld);
-  g_string_append_printf(load_data_suffix, "TERMINATED BY '%s' ", lines_terminated_by_ld);
+    g_string_append_printf(statement, "STARTING BY '%s' ",lines_starting_by_ld);
+  g_string_append_printf(statement, "TERMINATED BY '%s' ", lines_terminated_by_ld);
+}
+
+void initialize_load_data_statement_suffix(struct db_table *dbt, MYSQL_FIELD * fields, guint num_fields){
+//  gchar *character_set=set_names_in_conn_by_default != NULL ? set_names_in_conn_by_default : dbt->character_set /* "BINARY"*/;
+  GString *load_data_suffix=g_string_sized_new(statement_size);
+  g_string_append_printf(load_data_suffix, "%s' INTO TABLE %s%s%s ", exec_per_thread_extension, identifier_quote_character_str, dbt->table, identifier_quote_character_str);
+  append_load_data_format(load_data_suffix);
   if (include_header)
     g_string_append(load_data_suffix, "IGNORE 1 LINES ");
   g_string_append_printf(load_data_suffix, "(");
@@ -594,17 +702,178 @@ void initialize_load_data_header(struct db_table *dbt, MYSQL_FIELD *fields, guin
   g_string_append(dbt->load_data_header,lines_terminated_by);
 }
 
+// --max-memory: the buffers of every thread are accounted on a process wide
+// budget. Buffers that grew over their initial size on big rows are
+// replaced once the chunk is dumped, and a thread does not start a new chunk
+// while the budget is exceeded by memory that other threads are holding.
+// Extra memory is what a thread holds over the size its buffers have after
+// being released. Threads only wait while they hold no extra memory
+// themselves, so they can not wait for each other.
 static
-gboolean write_statement(int load_data_file, float *filessize, GString *statement, struct db_table * dbt){
-  if (!real_write_data(load_data_file, filessize, statement)) {
-    g_critical("Could not write out data for %s.%s", dbt->database->source_database, dbt->table);
-    return FALSE;
+guint64 get_thread_buffers_size(struct thread_data *td){
+  struct thread_data_buffers *b=&(td->thread_data_buffers);
+  return b->statement->allocated_len + b->row->allocated_len + b->column->allocated_len +
+         b->escaped->allocated_len + b->column_mask->allocated_len;
+}
+
+void account_thread_buffers(struct thread_data *td){
+  guint64 size=get_thread_buffers_size(td);
+  if (size == td->buffers_memory)
+    return;
+  g_mutex_lock(memory_budget_mutex);
+  buffers_memory+=size;
+  buffers_memory-=td->buffers_memory;
+  if (td->buffers_memory > THREAD_BUFFERS_RELEASED_SIZE)
+    buffers_extra_memory-=td->buffers_memory - THREAD_BUFFERS_RELEASED_SIZE;
+  if (size > THREAD_BUFFERS_RELEASED_SIZE)
+    buffers_extra_memory+=size - THREAD_BUFFERS_RELEASED_SIZE;
+  if (size < td->buffers_memory)
+    g_cond_broadcast(memory_budget_cond);
+  g_mutex_unlock(memory_budget_mutex);
+  td->buffers_memory=size;
+}
+
+static
+void shrink_buffer(GString **buffer, gsize size){
+  if ((*buffer)->allocated_len > 2 * size){
+    g_string_free(*buffer, TRUE);
+    *buffer=g_string_sized_new(size);
+  }
+}
+
+static
+void release_thread_buffers(struct thread_data *td){
+  struct thread_data_buffers *b=&(td->thread_data_buffers);
+  shrink_buffer(&(b->statement), 2*statement_size);
+  shrink_buffer(&(b->row), statement_size);
+  shrink_buffer(&(b->column), statement_size);
+  shrink_buffer(&(b->escaped), statement_size);
+  shrink_buffer(&(b->column_mask), statement_size);
+  b->target_column=b->column;
+  account_thread_buffers(td);
+}
+
+static
+void wait_for_memory_budget(struct thread_data *td){
+  if (max_memory == 0 || td->buffers_memory > THREAD_BUFFERS_RELEASED_SIZE)
+    return;
+  g_mutex_lock(memory_budget_mutex);
+  while (buffers_memory > (guint64)max_memory * 1024 * 1024 && buffers_extra_memory > 0 && !shutdown_triggered){
+    trace("Thread %d: waiting for memory, %" G_GUINT64_FORMAT " bytes in use", td->thread_id, buffers_memory);
+    g_cond_wait(memory_budget_cond, memory_budget_mutex);
+  }
+  g_mutex_unlock(memory_budget_mutex);
+}
+
+// --async-write: every worker has a writer thread and two statement
+// buffers. The worker hands the filled statement to the writer and keeps
+// building the next one on the other buffer, it only waits when the writer
+// has not finished with the previous one.
+struct async_writer {
+  GThread *thread;
+  GAsyncQueue *pending;
+  GAsyncQueue *free_buffers;
+  // Set by the writer thread, checked and cleared by the worker
+  gint failed;
+};
+
+struct async_write {
+  int file;
+  GString *data;
+};
+
+static
+void *async_writer_thread(struct async_writer *aw){
+  struct async_write *w=NULL;
+  float filesize=0;
+  while ((w=g_async_queue_pop(aw->pending))->data != NULL){
+    if (!g_atomic_int_get(&(aw->failed)) && !real_write_data(w->file, &filesize, w->data))
+      g_atomic_int_set(&(aw->failed), TRUE);
+    g_string_set_size(w->data, 0);
+    g_async_queue_push(aw->free_buffers, w->data);
+    g_free(w);
   }
+  g_free(w);
+  return NULL;
+}
+
+void initialize_async_writer(struct thread_data *td){
+  struct async_writer *aw=g_new0(struct async_writer, 1);
+  aw->pending=g_async_queue_new();
+  aw->free_buffers=g_async_queue_new();
+  g_async_queue_push(aw->free_buffers, g_string_sized_new(2*statement_size));
+  aw->thread=m_thread_new("writer", (GThreadFunc)async_writer_thread, aw, "Writer thread could not be created");
+  td->async_writer=aw;
+}
+
+// Must be called before closing a file that has been written asynchronously.
+// Returns FALSE when a write failed since the previous call.
+gboolean wait_async_writes(struct thread_data *td){
+  if (td == NULL || td->async_writer == NULL)
+    return TRUE;
+  g_async_queue_push(td->async_writer->free_buffers, g_async_queue_pop(td->async_writer->free_buffers));
+  return !g_atomic_int_compare_and_exchange(&(td->async_writer->failed), TRUE, FALSE);
+}
+
+// The statements are only written into the rows file, so a failure belongs
+// to the file that is open on the table job
+void wait_table_job_writes(struct table_job *tj){
+  if (wait_async_writes(tj->td))
+    return;
+  emit_dump_write_event(G_LOG_LEVEL_CRITICAL, "could not write data",
+                        "failed", tj, tj->rows ? tj->rows->filename : NULL, 0);
+  g_critical("Thread %d: Could not write out data for %s.%s into %s", tj->td->thread_id, tj->dbt->database->source_database, tj->dbt->table,
+             tj->rows && tj->rows->filename ? tj->rows->filename : "");
+  errors++;
+}
+
+void finalize_async_writer(struct thread_data *td){
+  struct async_writer *aw=td->async_writer;
+  if (aw == NULL)
+    return;
+  g_async_queue_push(aw->pending, g_new0(struct async_write, 1));
+  g_thread_join(aw->thread);
+  if (g_atomic_int_get(&(aw->failed))){
+    g_critical("Thread %d: Could not write out data", td->thread_id);
+    errors++;
+  }
+  g_string_free(g_async_queue_pop(aw->free_buffers), TRUE);
+  g_async_queue_unref(aw->pending);
+  g_async_queue_unref(aw->free_buffers);
+  g_free(aw);
+  td->async_writer=NULL;
+}
+
+static
+gboolean async_write_statement(struct thread_data *td, int file, float *filessize){
+  struct async_writer *aw=td->async_writer;
+  struct async_write *w=NULL;
+  if (g_atomic_int_get(&(aw->failed)))
+    return FALSE;
+  w=g_new(struct async_write, 1);
+  w->file=file;
+  w->data=td->thread_data_buffers.statement;
+  *filessize+=w->data->len;
+  g_async_queue_push(aw->pending, w);
+  td->thread_data_buffers.statement=g_async_queue_pop(aw->free_buffers);
+  return TRUE;
+}
+
+static
+gboolean write_statement(struct thread_data *td, int load_data_file, float *filessize, struct db_table * dbt){
+  GString *statement=td->thread_data_buffers.statement;
   g_mutex_lock(max_statement_size_mutex);
   if (statement->len > max_statement_size)
     max_statement_size=statement->len;
   g_mutex_unlock(max_statement_size_mutex);
-  g_string_set_size(statement, 0);
+  if (td->async_writer ? !async_write_statement(td, load_data_file, filessize)
+                       : !real_write_data(load_data_file, filessize, statement)) {
+    g_critical("Could not write out data for %s.%s", dbt->database->source_database, dbt->table);
+    return FALSE;
+  }
+  g_string_set_size(td->thread_data_buffers.statement, 0);
+  if (max_memory > 0)
+    account_thread_buffers(td);
   return TRUE;
 }
 
@@ -721,6 +990,7 @@ void write_column_into_string_with_terminated_by(MYSQL *conn, gchar * column_i,
       // apply and constant as they alter the data
       write_column_into_string( conn, column, field, rlength, buffers);
       trace("Buffer.column initial: %s with column: %s", buffers.column->str, column);
+      rlength=buffers.column->len;
       f->function(buffers.column_mask, buffers.column->str, &rlength, f);
       trace("Buffer.column_mask changed: %s", buffers.column_mask->str);
       g_string_assign(buffers.column,buffers.column_mask->str);
@@ -741,15 +1011,19 @@ void write_column_into_string_with_terminated_by(MYSQL *conn, gchar * column_i,
       if (f->is_pre){
         // apply and constant as they alter the data
         trace("Buffer.column initial: %s with column: %s", buffers.column->str, column);
+        rlength=buffers.column->len;
         f->function(buffers.column_mask, buffers.column->str, &rlength, f);
         trace("Buffer.column_mask changed: %s", buffers.column_mask->str);
         g_string_assign(buffers.column,buffers.column_mask->str);      
         trace("Buffer.column final: %s", buffers.column->str);
       }else{
         trace("Buffer.column initial: %s with column: %s", buffers.column->str, column);
-        if (f->function(buffers.column_mask, buffers.column->str, &rlength, f))
-          g_string_assign(buffers.column,buffers.column_mask->str);
-        else{
+        // The value is passed with its length, as it might have zeros inside
+        rlength=buffers.column->len;
+        if (f->function(buffers.column_mask, buffers.column->str, &rlength, f)){
+          g_string_set_size(buffers.column,0);
+          g_string_append_len(buffers.column,buffers.column_mask->str,buffers.column_mask->len);
+        }else{
           g_string_set_size(buffers.column,0);
           write_column_into_string( conn, NULL, field, 0, buffers);
         }
@@ -821,7 +1095,12 @@ void flush_dbt_rows(struct thread_data *td){
 
 static
 void close_file(struct table_job * tj, struct table_job_file *tjf){
-  if (tjf->file >= 0){
+  if (tjf->file >= 0 && tj->dbt->coalesce){
+    close_bundle_segment(tj);
+  }else if (tjf->file >= 0){
+    wait_table_job_writes(tj);
+    if (zstd_frame_size > 0 && tjf == tj->rows)
+      m_last_zstd_frame(tjf->filename, tj->frame_filesize);
     m_close(tj->td->thread_id, tjf->file, tjf->filename, tj->filesize, tj->dbt);
     tjf->file=-1;
     g_free(tjf->filename);
@@ -842,6 +1121,7 @@ void close_table_job_files(struct table_job * tj){
   close_file(tj, tj->rows);
 
   tj->filesize=0;
+  tj->frame_filesize=0;
   tj->st_in_file=0;
 
   tj->num_rows_of_last_run=0;
@@ -871,6 +1151,18 @@ void reopen_files(struct table_job * tj){
 }
 
 
+// --zstd-frame-size: a frame ends on a statement boundary and the next one
+// starts with the headers, so myloader can restore each frame by itself
+static
+gboolean next_zstd_frame(struct table_job *tj){
+  if (tj->frame_filesize < (guint64)zstd_frame_size*1024*1024)
+    return FALSE;
+  wait_table_job_writes(tj);
+  tj->rows->file=m_next_zstd_frame(tj->rows->file, tj->rows->filename, tj->frame_filesize);
+  tj->frame_filesize=0;
+  return TRUE;
+}
+
 void write_result_into_file(MYSQL *conn, MYSQL_RES *result, struct table_job * tj){
 	struct db_table * dbt = tj->dbt;
   guint num_fields = mysql_num_fields(result);
@@ -962,11 +1254,12 @@ void write_result_into_file(MYSQL *conn, MYSQL_RES *result, struct table_job * t
                 dbt->table);
       }
       g_string_append(tj->td->thread_data_buffers.statement, statement_terminated_by);
-      if (!write_statement(tj->rows->file, &(tj->filesize), tj->td->thread_data_buffers.statement, dbt)) {
+      tj->frame_filesize+=tj->td->thread_data_buffers.statement->len;
+      if (!write_statement(tj->td, tj->rows->file, &(tj->filesize), dbt)) {
         emit_dump_write_event(G_LOG_LEVEL_CRITICAL, "failed to write chunk statement",
                               "failed", tj, tj->rows->filename, errno);
         g_critical("Fail to write on %s", tj->rows->filename);
-        return;
+        goto release;
       }
 			update_dbt_rows_batched(tj->td, dbt, num_rows);
       tj->num_rows_of_last_run+=num_rows;
@@ -975,6 +1268,8 @@ void write_result_into_file(MYSQL *conn, MYSQL_RES *result, struct table_job * t
 			tj->st_in_file++;
     // initilize buffer if needed (INSERT INTO)
       if (output_format == SQL_INSERT || output_format == CLICKHOUSE){
+        if (zstd_frame_size > 0 && next_zstd_frame(tj))
+          initialize_sql_statement(tj->td->thread_data_buffers.statement);
 				g_string_append(tj->td->thread_data_buffers.statement, dbt->insert_statement->str);
 			}
       // Perf: Zero-allocation time check using monotonic time
@@ -986,7 +1281,7 @@ void write_result_into_file(MYSQL *conn, MYSQL_RES *result, struct table_job * t
 
 			check_pause_resume(tj->td);
       if (shutdown_triggered) {
-        return;
+        goto release;
       }
 		}
 		// if file size exceeded limit, we need to rotate
@@ -1015,14 +1310,20 @@ void write_result_into_file(MYSQL *conn, MYSQL_RES *result, struct table_job * t
   if (num_rows_st > 0 && tj->td->thread_data_buffers.statement->len > 0){
     if (output_format == SQL_INSERT || output_format == CLICKHOUSE)
 			g_string_append(tj->td->thread_data_buffers.statement, statement_terminated_by);
-    if (!write_statement(tj->rows->file, &(tj->filesize), tj->td->thread_data_buffers.statement, dbt)) {
+    tj->frame_filesize+=tj->td->thread_data_buffers.statement->len;
+    if (!write_statement(tj->td, tj->rows->file, &(tj->filesize), dbt)) {
       emit_dump_write_event(G_LOG_LEVEL_CRITICAL, "failed to write final chunk statement",
                             "failed", tj, tj->rows->filename, errno);
       g_critical("Fail to write on %s", tj->rows->filename);
-      return;
+      goto release;
     }
 		tj->st_in_file++;
   }
+release:
+  // Also on failures, as the thread would hold its extra memory while it
+  // waits for the budget on the next chunk
+  if (max_memory > 0)
+    release_thread_buffers(tj->td);
   // Note: No cleanup needed - g_get_monotonic_time() has zero allocations
 
 //  g_string_free(statement, TRUE);
@@ -1031,6 +1332,148 @@ void write_result_into_file(MYSQL *conn, MYSQL_RES *result, struct table_job * t
   return;
 }
 
+static
+gchar *build_table_job_query(struct table_job * tj, const gchar *select_fields){
+  return g_strdup_printf(
+      "SELECT %s %s FROM %s%s%s.%s%s%s %s %s %s %s %s %s %s %s %s %s %s",
+      is_mysql_like() ? "/*!40001 SQL_NO_CACHE */" : "",
+      select_fields,
+      identifier_quote_character_str,tj->dbt->database->source_database, identifier_quote_character_str, identifier_quote_character_str, tj->dbt->table, identifier_quote_character_str, tj->partition?tj->partition:"",
+       (tj->where->len || where_option   || tj->dbt->where) ? "WHERE"  : "" , tj->where->len ? tj->where->str : "",
+       (tj->where->len && where_option )                    ? "AND"    : "" ,   where_option ?   where_option : "",
+      ((tj->where->len || where_option ) && tj->dbt->where) ? "AND"    : "" , tj->dbt->where ? tj->dbt->where : "",
+      order_by_primary_key && tj->dbt->primary_key_separated_by_comma ? " ORDER BY " : "", order_by_primary_key && tj->dbt->primary_key_separated_by_comma ? tj->dbt->primary_key_separated_by_comma : "",
+      tj->dbt->limit ?  "LIMIT" : "", tj->dbt->limit ? tj->dbt->limit : "");
+}
+
+// --server-outfile: the LOAD DATA statement needs the fields of the table,
+// and the hex blobs are selected with HEX() as LOAD DATA uses UNHEX()
+static
+void initialize_outfile(struct table_job * tj){
+  struct db_table *dbt=tj->dbt;
+  g_mutex_lock(dbt->write_mutex);
+  if (dbt->load_data_suffix==NULL){
+    gchar *query=g_strdup_printf("SELECT %s FROM %s%s%s.%s%s%s LIMIT 0",
+      dbt->select_fields?dbt->select_fields->str:"*",
+      identifier_quote_character_str, dbt->database->source_database, identifier_quote_character_str,
+      identifier_quote_character_str, dbt->table, identifier_quote_character_str);
+    MYSQL_RES *result=m_store_result_free_query(tj->td->thrconn, query, m_critical, "Failed to get the fields of %s.%s", dbt->database->source_database, dbt->table);
+    guint num_fields = mysql_num_fields(result);
+    MYSQL_FIELD *fields = mysql_fetch_fields(result);
+    guint i;
+    dbt->outfile_fields=g_string_new(NULL);
+    for (i = 0; i < num_fields; ++i) {
+      if (i > 0)
+        g_string_append_c(dbt->outfile_fields, ',');
+      g_string_append(dbt->outfile_fields, is_hex_blob(fields[i]) ? "HEX(" : "");
+      g_string_append(dbt->outfile_fields, identifier_quote_character_str);
+      g_string_append(dbt->outfile_fields, fields[i].name);
+      g_string_append(dbt->outfile_fields, identifier_quote_character_str);
+      g_string_append(dbt->outfile_fields, is_hex_blob(fields[i]) ? ")" : "");
+    }
+    initialize_load_data_statement_suffix(dbt, fields, num_fields);
+    mysql_free_result(result);
+  }
+  g_mutex_unlock(dbt->write_mutex);
+}
+
+// When secure_file_priv is a directory, the server writes there and the file
+// is moved to the dump directory, which needs both on the same filesystem or
+// permission to read the file
+static
+gboolean move_outfile(gchar *outfile, gchar *filename){
+  if (!g_rename(outfile, filename))
+    return TRUE;
+  GFile *source=g_file_new_for_path(outfile), *destination=g_file_new_for_path(filename);
+  GError *error=NULL;
+  gboolean r=g_file_copy(source, destination, G_FILE_COPY_OVERWRITE, NULL, NULL, NULL, &error);
+  if (!r){
+    g_critical("Not able to move %s to %s: %s", outfile, filename, error->message);
+    g_error_free(error);
+  }else if (g_remove(outfile))
+    g_warning("Not able to remove %s after copying it to %s", outfile, filename);
+  g_object_unref(source);
+  g_object_unref(destination);
+  return r;
+}
+
+// --server-outfile: the server writes the rows file of the chunk with
+// SELECT ... INTO OUTFILE and mydumper only writes the LOAD DATA statement.
+// The rows file is opened after it was written, so it is closed and
+// streamed like the other files.
+static
+void write_table_job_into_outfile(struct table_job * tj){
+  MYSQL *conn = tj->td->thrconn;
+  if (tj->dbt->load_data_suffix==NULL)
+    initialize_outfile(tj);
+  // The server does not append to a file, so each query needs a new one
+  if (tj->rows->file >= 0 || tj->sql->file >= 0){
+    close_table_job_files(tj);
+    tj->sub_part++;
+  }
+  gchar *filename=build_rows_filename(tj->dbt->database->database_name_in_filename, tj->dbt->table_filename, tj->part, tj->sub_part);
+  tj->rows->filename=filename;
+
+  gchar *outfile=NULL;
+  if (secure_file_priv && *secure_file_priv){
+    gchar *basename=g_path_get_basename(filename);
+    outfile=g_build_filename(secure_file_priv, basename, NULL);
+    g_free(basename);
+  }else if (g_path_is_absolute(filename)){
+    outfile=g_strdup(filename);
+  }else{
+    gchar *current_dir=g_get_current_dir();
+    outfile=g_build_filename(current_dir, filename, NULL);
+    g_free(current_dir);
+  }
+  gsize outfile_length=strlen(outfile);
+  gchar *escaped_outfile=g_new(gchar, outfile_length * 2 + 1);
+  mysql_real_escape_string(conn, escaped_outfile, outfile, outfile_length);
+  gchar *select=build_table_job_query(tj, tj->dbt->outfile_fields->str);
+  GString *query=g_string_new(select);
+  g_string_append_printf(query, " INTO OUTFILE '%s' ", escaped_outfile);
+  append_load_data_format(query);
+  g_free(select);
+  g_free(escaped_outfile);
+
+  message_dumping_data(tj);
+  if (m_query(conn, query->str, m_warning, "Failed to execute query", NULL)){
+    emit_dump_write_event(G_LOG_LEVEL_CRITICAL, "failed to execute dump query",
+                          "failed", tj, filename, mysql_errno(conn));
+    g_critical("Thread %d: Error dumping table (%s.%s) data into %s: %s", tj->td->thread_id, tj->dbt->database->source_database, tj->dbt->table,
+               outfile, mysql_error(conn));
+  }else{
+    guint64 num_rows=mysql_affected_rows(conn);
+    // The statement file is only created when there is a rows file to load
+    tj->sql->filename=build_sql_filename(tj->dbt->database->database_name_in_filename, tj->dbt->table_filename, tj->part, tj->sub_part);
+    tj->sql->file=m_open(&(tj->sql->filename),"w");
+    write_load_data_statement(tj);
+    if (g_strcmp0(outfile, filename) && !move_outfile(outfile, filename))
+      errors++;
+    tj->rows->file=g_open(filename, O_RDONLY, 0);
+    if (tj->rows->file < 0){
+      g_critical("Thread %d: Not able to open %s (%d)", tj->td->thread_id, filename, errno);
+      errors++;
+    }else{
+      struct stat st;
+      dump_summary_note_file_created();
+      if (!fstat(tj->rows->file, &st)){
+        tj->filesize+=st.st_size;
+        dump_summary_add_bytes((guint64)st.st_size);
+      }
+    }
+    update_dbt_rows_batched(tj->td, tj->dbt, num_rows);
+    flush_dbt_rows(tj->td);
+    tj->num_rows_of_last_run+=num_rows;
+  }
+  if (tj->rows->file < 0){
+    g_free(tj->rows->filename);
+    tj->rows->filename=NULL;
+  }
+  g_string_free(query, TRUE);
+  g_free(outfile);
+}
+
 /* Do actual data chunk reading/writing magic */
 void write_table_job_into_file(struct table_job * tj){
   MYSQL *conn = tj->td->thrconn;
@@ -1041,20 +1484,20 @@ void write_table_job_into_file(struct table_job * tj){
 
   tj->num_rows_of_last_run=0;
 
+  // The masquerade functions are applied on the rows that mydumper fetches
+  if (server_outfile && !tj->dbt->has_anonymized_function){
+    write_table_job_into_outfile(tj);
+    return;
+  }
+
+  // Waiting after the query was sent could hit net_write_timeout, as the
+  // server would be blocked sending the rows
+  wait_for_memory_budget(tj->td);
+
   /* Ghm, not sure if this should be statement_size - but default isn't too big
    * for now */
   /* Poor man's database code */
-  MYSQL_RES *result = m_use_result(conn, query = g_strdup_printf(
-      "SELECT %s %s FROM %s%s%s.%s%s%s %s %s %s %s %s %s %s %s %s %s %s",
-      is_mysql_like() ? "/*!40001 SQL_NO_CACHE */" : "",
-      tj->dbt->select_fields?tj->dbt->select_fields->str:"*",
-      identifier_quote_character_str,tj->dbt->database->source_database, identifier_quote_character_str, identifier_quote_character_str, tj->dbt->table, identifier_quote_character_str, tj->partition?tj->partition:"",
-       (tj->where->len || where_option   || tj->dbt->where) ? "WHERE"  : "" , tj->where->len ? tj->where->str : "",
-       (tj->where->len && where_option )                    ? "AND"    : "" ,   where_option ?   where_option : "",
-      ((tj->where->len || where_option ) && tj->dbt->where) ? "AND"    : "" , tj->dbt->where ? tj->dbt->where : "",
-      order_by_primary_key && tj->dbt->primary_key_separated_by_comma ? " ORDER BY " : "", order_by_primary_key && tj->dbt->primary_key_separated_by_comma ? tj->dbt->primary_key_separated_by_comma : "",
-      tj->dbt->limit ?  "LIMIT" : "", tj->dbt->limit ? tj->dbt->limit : ""
-  ), m_warning, "Failed to execute query", NULL);
+  MYSQL_RES *result = m_use_result(conn, query = build_table_job_query(tj, tj->dbt->select_fields?tj->dbt->select_fields->str:"*"), m_warning, "Failed to execute query", NULL);
 
   if (!result){
     if (!it_is_a_consistent_backup){
@@ -32,6 +32,13 @@ void finalize_write();
 void write_table_job_into_file(struct table_job *tj);
 gboolean write_data(int file, GString *data);
 void close_table_job_files(struct table_job * tj);
+void account_thread_buffers(struct thread_data *td);
+void initialize_async_writer(struct thread_data *td);
+gboolean wait_async_writes(struct thread_data *td);
+void wait_table_job_writes(struct table_job *tj);
+void finalize_async_writer(struct thread_data *td);
+void close_bundle_segment(struct table_job *tj);
+void close_bundle(struct thread_data *td);
 
 // Thread-local row batching: accumulates rows locally, flushes every 10K rows
 // update_dbt_rows_batched: Thread-local batching (call during processing)
@@ -119,6 +119,15 @@ void detect_group_replication_transaction_size_limit(MYSQL * conn) {
   m_store_result_row_free(mr);
 }
 
+// The transportable tablespaces are copied into the datadir of the server
+static
+void detect_datadir(MYSQL * conn) {
+  struct M_ROW *mr = m_store_result_row(conn, "SELECT @@datadir",m_warning, m_message, "Not able to get @@datadir", NULL);
+  if (mr->row && mr->row[0])
+    datadir=g_strdup(mr->row[0]);
+  m_store_result_row_free(mr);
+}
+
 gchar * print_time(GTimeSpan timespan){
   GTimeSpan days   = timespan/G_TIME_SPAN_DAY;
   GTimeSpan hours  =(timespan-(days*G_TIME_SPAN_DAY))/G_TIME_SPAN_HOUR;
@@ -245,11 +254,14 @@ void print_help(){
   print_int("max-threads-for-schema-creation",max_threads_for_schema_creation, FALSE);
   print_string("exec-per-thread",exec_per_thread);
   print_string("exec-per-thread-extension",exec_per_thread_extension);
+  print_string("encryption-key-file",encryption_key_file);
+  print_string("datadir",datadir);
 
   print_int("rows",rows, rows==0);
   print_int("queries-per-transaction",commit_count, FALSE);
   print_int("max-statement-size",max_statement_size,max_statement_size==0);
   print_int("max-transaction-size",max_transaction_size, FALSE);
+  print_bool("insert-as-load-data",insert_as_load_data);
   print_bool("append-if-not-exist",append_if_not_exist);
   print_string("set-names",set_names_in_conn_by_default);
   print_bool("skip-definer",skip_definer);
@@ -501,6 +513,9 @@ int main(int argc, char *argv[]) {
   initialize_process(&conf);
   initialize_table(&conf);
   initialize_database();
+  // The rows of the INSERT statements are sent as local files
+  if (insert_as_load_data)
+    local_infile=TRUE;
   initialize_common();
   initialize_connection(MYLOADER);
   initialize_regex(NULL);
@@ -528,6 +543,8 @@ int main(int argc, char *argv[]) {
   load_per_table_info_from_key_file(key_file, conf_per_table, NULL );
   if (max_transaction_size == DEFAULT_MAX_TRANSACTION_SIZE)
     detect_group_replication_transaction_size_limit(conn);
+  if (datadir == NULL)
+    detect_datadir(conn);
 
   // To here.
   conf.database_queue = g_async_queue_new();
@@ -539,6 +556,7 @@ int main(int argc, char *argv[]) {
   conf.index_queue = g_async_queue_new();
   conf.ready_table_queue = g_async_queue_new();
   conf.view_queue = g_async_queue_new();
+  initialize_view_graph();
   conf.ready = g_async_queue_new();
   conf.pause_resume = g_async_queue_new();
   conf.table_list_mutex = g_mutex_new();
@@ -556,6 +574,9 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  if (encryption_key_file)
+    initialize_encryption();
+
   initialize_connection_pool();
   struct thread_data *t=g_new(struct thread_data,1);
   initialize_thread_data(t, &conf, WAITING, 0, NULL);
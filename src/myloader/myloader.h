@@ -25,6 +25,7 @@
 #include "../regex.h"
 #include "../server_detect.h"
 #include "../pmm_thread.h"
+#include "../encryption.h"
 #include "../checksum.h"
 #include "myloader_table.h"
 #ifndef _src_myloader_h
@@ -52,9 +53,27 @@ struct database;
 
 enum thread_states { WAITING, STARTED, COMPLETED };
 
+// Bounded queue of statements between a file and its connections
+struct statement_ring_cell{
+  gint sequence;
+  gpointer data;
+};
+
+struct statement_ring{
+  struct statement_ring_cell *cells;
+  guint mask;
+  gint enqueue_pos;
+  gint dequeue_pos;
+  // Counters that the waiters sleep on when the ring is empty or full
+  gint pushed;
+  gint popped;
+  gint pop_waiters;
+  gint push_waiters;
+};
+
 struct io_restore_result{
-  GAsyncQueue *restore;
-  GAsyncQueue *result;
+  struct statement_ring *restore;
+  struct statement_ring *result;
 };
 
 struct connection_data{
@@ -66,6 +85,11 @@ struct connection_data{
   GAsyncQueue * ready;
   gboolean transaction;
   GMutex *in_use;
+  // Reused by every split INSERT executed on this connection
+  GString *insert_buffer;
+  // Cached for --insert-as-load-data, NULL until the connection is queried
+  gchar *character_set;
+  gboolean strict_mode;
   
 };
 
@@ -148,6 +172,7 @@ enum file_type {
   SCHEMA_CREATE, 
   SCHEMA_TABLE,
   DATA,
+  BUNDLE,
   LOAD_DATA,
   SCHEMA_VIEW, 
   SCHEMA_TRIGGER, 
@@ -175,6 +200,8 @@ const char *ft2str(enum file_type ft){
     return "SCHEMA_TABLE";
   case DATA:
     return "DATA";
+  case BUNDLE:
+    return "BUNDLE";
   case LOAD_DATA:
     return "LOAD_DATA";
   case SCHEMA_VIEW:
@@ -245,6 +245,11 @@ static GOptionEntry statement_entries[] ={
      "Informs what is the max statement size. Currently not being used.", NULL},
     {"max-transaction-size", 0, 0, G_OPTION_ARG_INT, &max_transaction_size,
      "Set the max size of the transaction in megabytes, default 1000", NULL},
+    {"insert-as-load-data", 0, 0, G_OPTION_ARG_NONE, &insert_as_load_data,
+     "Executes the INSERT statements of the tables without triggers as LOAD DATA LOCAL INFILE, sending their rows from memory. "
+     "Implies --local-infile. Statements that LOAD DATA can't read as they are, like the ones with hexadecimal values, are executed as INSERT. "
+     "Each LOAD DATA has at most --rows rows. When the rows of an INSERT need several LOAD DATA or the sql_mode is strict, the table must be "
+     "transactional, and the rows are rolled back and executed as INSERT if a LOAD DATA fails or, in strict mode, returns warnings", NULL},
     {"append-if-not-exist", 0, 0, G_OPTION_ARG_NONE,&append_if_not_exist,
       "Appends IF NOT EXISTS to the create table statements. This will be removed when https://bugs.mysql.com/bug.php?id=103791 has been implemented", NULL},
     { "set-names",0, 0, G_OPTION_ARG_STRING, &set_names_in_conn_by_default,
@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/wait.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
 
@@ -494,7 +495,12 @@ gboolean m_filename_has_suffix(gchar const *str, gchar const *suffix){
   gsize str_len = strlen(str);
   gsize suffix_len = strlen(suffix);
 
-  if (has_exec_per_thread_extension(str)){
+  if (g_str_has_suffix(str, ENCRYPTION_EXTENSION)){
+    gchar *decrypted=g_strndup(str, str_len - strlen(ENCRYPTION_EXTENSION));
+    gboolean r=m_filename_has_suffix(decrypted, suffix);
+    g_free(decrypted);
+    return r;
+  }else if (has_exec_per_thread_extension(str)){
     gsize ext_len = strlen(exec_per_thread_extension);
     if (str_len > ext_len + suffix_len) {
       return g_strstr_len(&(str[str_len - ext_len - suffix_len]), str_len - ext_len, suffix) != NULL;
@@ -516,7 +522,7 @@ gboolean m_filename_has_suffix(gchar const *str, gchar const *suffix){
   return g_str_has_suffix(str, suffix);
 }
 
-static gboolean eval_table_filters_unlocked(char *db_name, char *table_name){
+static gboolean eval_table_filters(char *db_name, char *table_name){
   if ( tables ){
     if (!is_table_in_list( db_name, table_name, tables)){
       return FALSE;
@@ -557,23 +563,19 @@ static gboolean get_database_table_from_filename_for_filter(const gchar *filenam
   return *database != NULL && *table != NULL;
 }
 
-gboolean eval_table( char *db_name, char * table_name, GMutex * mutex){
-  gboolean matched = FALSE;
-
+// The filters are loaded before any thread starts and they are read-only
+// afterwards, so they are evaluated without taking table_list_mutex
+gboolean eval_table( char *db_name, char * table_name){
   if (table_name == NULL)
     g_error("Table name is null on eval_table()");
 
-  g_mutex_lock(mutex);
-  matched = eval_table_filters_unlocked(db_name, table_name);
-  g_mutex_unlock(mutex);
-
-  if (!matched)
+  if (!eval_table_filters(db_name, table_name))
     return FALSE;
 
   return eval_regex(db_name, table_name);
 }
 
-gboolean should_queue_filename(const gchar *filename, GMutex *mutex){
+gboolean should_queue_filename(const gchar *filename){
   gchar *database = NULL;
   gchar *table = NULL;
   gboolean matched = TRUE;
@@ -591,7 +593,7 @@ gboolean should_queue_filename(const gchar *filename, GMutex *mutex){
     return TRUE;
 
   if (get_database_table_from_filename_for_filter(filename, &database, &table))
-    matched = eval_table(database, table, mutex);
+    matched = eval_table(database, table);
 
   g_free(database);
   g_free(table);
@@ -798,13 +800,97 @@ int execute_file_per_thread( const gchar *sql_fn, gchar *sql_fn3, gchar **exec){
   return childpid;
 }
 
+// The command reads from the fd in, which the child keeps after exec
+int execute_fd_per_thread( int in, gchar *sql_fn3, gchar **exec){
+  int childpid=fork();
+  if(!childpid){
+    FILE *sql_file3 = g_fopen(sql_fn3,"w");
+    dup2(in, STDIN_FILENO);
+    dup2(fileno(sql_file3), STDOUT_FILENO);
+    execv(exec[0],exec);
+    _exit(EXIT_FAILURE);
+  }
+  return childpid;
+}
+
+// The child copies the range of sql_fn to the command, which is its
+// grandchild, through a pipe
+int execute_range_per_thread( const gchar *sql_fn, guint64 offset, guint64 length, gchar *sql_fn3, gchar **exec){
+  int childpid=fork();
+  if(!childpid){
+    int p[2];
+    if (pipe(p))
+      _exit(EXIT_FAILURE);
+    int decompressor=fork();
+    if (!decompressor){
+      FILE *sql_file3 = g_fopen(sql_fn3,"w");
+      dup2(p[0], STDIN_FILENO);
+      close(p[0]);
+      close(p[1]);
+      dup2(fileno(sql_file3), STDOUT_FILENO);
+      execv(exec[0],exec);
+      _exit(EXIT_FAILURE);
+    }
+    close(p[0]);
+    char buffer[65536];
+    ssize_t r=0, w=0, done=0;
+    int in=open(sql_fn, O_RDONLY);
+    if (in >= 0 && lseek(in, offset, SEEK_SET) == (off_t)offset){
+      while (length > 0 && (r=read(in, buffer, length < sizeof(buffer) ? length : sizeof(buffer))) > 0){
+        for (done=0; done < r; done+=w)
+          if ((w=write(p[1], buffer + done, r - done)) <= 0)
+            _exit(EXIT_FAILURE);
+        length-=r;
+      }
+    }
+    close(p[1]);
+    int status=0;
+    waitpid(decompressor, &status, 0);
+    _exit(length == 0 && WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE);
+  }
+  return childpid;
+}
+
+// Dumps taken with --zstd-dictionary have the dictionary on the directory.
+// On stream, it is received before any file that was compressed with it.
+static gchar ** zstd_dictionary_decompress_cmd = NULL;
+static gboolean zstd_dictionary_checked = FALSE;
+
+static
+gchar ** get_zstd_decompress_cmd(){
+  gchar **cmd=g_atomic_pointer_get(&zstd_dictionary_decompress_cmd);
+  if (cmd)
+    return cmd;
+  if (zstd_decompress_cmd == NULL || zstd_dictionary_checked)
+    return zstd_decompress_cmd;
+  gchar *dictionary=g_build_filename(directory, ZSTD_DICTIONARY_FILENAME, NULL);
+  if (!g_file_test(dictionary, G_FILE_TEST_IS_REGULAR)){
+    g_free(dictionary);
+    if (!stream)
+      zstd_dictionary_checked=TRUE;
+    return zstd_decompress_cmd;
+  }
+  guint n=g_strv_length(zstd_decompress_cmd);
+  cmd=g_new0(gchar *, n + 3);
+  memcpy(cmd, zstd_decompress_cmd, n * sizeof(gchar *));
+  cmd[n]=g_strdup("-D");
+  cmd[n+1]=dictionary;
+  if (!g_atomic_pointer_compare_and_exchange(&zstd_dictionary_decompress_cmd, NULL, cmd)){
+    g_free(cmd[n]);
+    g_free(dictionary);
+    g_free(cmd);
+  }else
+    g_message("Using zstd dictionary %s", dictionary);
+  return g_atomic_pointer_get(&zstd_dictionary_decompress_cmd);
+}
+
 gboolean get_command_and_basename(gchar *filename, gchar ***command, gchar **basename){
   int len=0;
   if (has_exec_per_thread_extension(filename)) {
     *command=exec_per_thread_cmd;
     len=strlen(exec_per_thread_extension);
   }else if ( g_str_has_suffix(filename, ZSTD_EXTENSION) ){
-    *command=zstd_decompress_cmd;
+    *command=get_zstd_decompress_cmd();
     len=strlen(ZSTD_EXTENSION);
   }else if (g_str_has_suffix(filename, GZIP_EXTENSION)){
     *command=gzip_decompress_cmd;
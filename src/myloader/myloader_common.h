@@ -20,8 +20,8 @@
 #include "myloader.h"
 #include <stdio.h> 
 //enum file_type get_file_type (const char * filename);
-gboolean eval_table( char *db_name, char * table_name, GMutex * mutex);
-gboolean should_queue_filename(const gchar *filename, GMutex *mutex);
+gboolean eval_table( char *db_name, char * table_name);
+gboolean should_queue_filename(const gchar *filename);
 void get_database_table_from_file(const gchar *filename,const char *sufix,gchar **database,gchar **table);
 int process_create_table_statement (gchar * statement, GString *create_table_statement, GString *alter_table_statement, GString *alter_table_constraint_statement, struct db_table *dbt, gboolean split_indexes);
 void finish_alter_table(GString * alter_table_statement);
@@ -32,6 +32,8 @@ void checksum_databases(struct thread_data *td);
 void checksum_table_filename(const gchar *filename, MYSQL *conn);
 //int execute_file_per_thread( const gchar *sql_fn, gchar *sql_fn3);
 int execute_file_per_thread( const gchar *sql_fn, gchar *sql_fn3, gchar **exec);
+int execute_fd_per_thread( int in, gchar *sql_fn3, gchar **exec);
+int execute_range_per_thread( const gchar *sql_fn, guint64 offset, guint64 length, gchar *sql_fn3, gchar **exec);
 gboolean has_compession_extension(const gchar *filename);
 gboolean has_exec_per_thread_extension(const gchar *filename);
 gboolean checksum_database_template(gchar *_db, gchar *dbt_checksum,  MYSQL *conn,
@@ -146,10 +146,22 @@ void execute_use_if_needs_to(struct connection_data *cd, struct database *databa
 
 void create_database(struct thread_data *td, gchar *database) {
 
-  const gchar *filename =
+  gchar *filename =
       g_strdup_printf("%s-schema-create.sql%s", database, exec_per_thread_extension?exec_per_thread_extension:"");
-  const gchar *filepath = g_strdup_printf("%s/%s",
+  gchar *filepath = g_strdup_printf("%s/%s",
                                             directory, filename);
+  // The schema file might not be encrypted even if --encryption-key-file is used
+  if (encryption_key_file){
+    gchar *encrypted_filepath = g_strdup_printf("%s%s", filepath, ENCRYPTION_EXTENSION);
+    if (g_file_test(encrypted_filepath, G_FILE_TEST_EXISTS)){
+      g_free(filepath);
+      filepath = encrypted_filepath;
+      gchar *encrypted_filename = g_strdup_printf("%s%s", filename, ENCRYPTION_EXTENSION);
+      g_free(filename);
+      filename = encrypted_filename;
+    }else
+      g_free(encrypted_filepath);
+  }
 
   if (drop_database)
     execute_drop_database(td, database);
@@ -165,8 +177,8 @@ void create_database(struct thread_data *td, gchar *database) {
       g_atomic_int_inc(&(detailed_errors.schema_errors));
     g_string_free(data, TRUE);
   }
-
-  return;
+  g_free(filename);
+  g_free(filepath);
 }
 
 void start_database(struct thread_data *td){
@@ -114,7 +114,7 @@ void *process_directory(struct configuration *conf){
   }else{
     GDir *dir = g_dir_open(directory, 0, &error);
     while ((filename = g_dir_read_name(dir))){
-      if (should_queue_filename(filename, conf->table_list_mutex))
+      if (should_queue_filename(filename))
         process_filename_push(filename);
     }
     g_dir_close(dir);
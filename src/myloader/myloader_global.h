@@ -47,6 +47,7 @@ extern gboolean overwrite_unsafe;
 extern gboolean resume;
 extern gboolean shutdown_triggered;
 extern gboolean skip_definer;
+extern gboolean insert_as_load_data;
 extern gchar *replace_definer;
 extern gboolean skip_post;
 extern gboolean skip_create_table;
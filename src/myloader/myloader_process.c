@@ -24,6 +24,7 @@
 #include <errno.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "myloader.h"
 #include "myloader_stream.h"
@@ -37,6 +38,7 @@
 #include "myloader_directory.h"
 #include "myloader_worker_loader_main.h"
 #include "myloader_worker_schema.h"
+#include "myloader_worker_post.h"
 
 
 struct replication_statements *replication_statements=NULL;
@@ -45,6 +47,7 @@ GHashTable *fifo_hash=NULL;
 GMutex *fifo_table_mutex=NULL;
 struct configuration *_conf;
 extern gboolean schema_sequence_fix;
+extern gchar *replace_definer_str;
 GAsyncQueue *partial_metadata_queue = NULL;
 static GRecMutex *metadata_process_mutex = NULL;
 
@@ -86,82 +89,130 @@ static void release_decompressor_slot(void){
   g_mutex_unlock(decompress_mutex);
 }
 
-FILE * myl_open(char *filename, const char *type){
+// length is 0 when the whole file is decompressed. Otherwise only that range
+// is, and the fifo name has the offset as several ranges of the same file
+// can be open at the same time. When in is not -1, the command reads from it
+// instead of from filename.
+static
+FILE *open_decompressor(char *filename, const char *type, gchar **command, gchar *basename, int in, guint64 offset, guint64 length){
   FILE *file=NULL;
-  gchar *basename=NULL, *fifoname=NULL;
+  gchar *fifoname=NULL;
   int child_proc;
-  (void) child_proc;
-  gchar **command=NULL;
   struct stat a;
-  trace("myl_open %s", filename);
-  if (get_command_and_basename(filename, &command, &basename)){
-    // Acquire decompressor slot (throttle concurrent processes)
-    g_mutex_lock(decompress_mutex);
-    while (g_atomic_int_dec_and_test(&active_decompressors)){
-      g_atomic_int_inc(&active_decompressors);
-      g_cond_wait(decompress_cond, decompress_mutex);
-    }
-    g_mutex_unlock(decompress_mutex);
+  // Acquire decompressor slot (throttle concurrent processes)
+  g_mutex_lock(decompress_mutex);
+  while (g_atomic_int_dec_and_test(&active_decompressors)){
+    g_atomic_int_inc(&active_decompressors);
+    g_cond_wait(decompress_cond, decompress_mutex);
+  }
+  g_mutex_unlock(decompress_mutex);
 
-    fifoname=basename;
-    if (fifo_directory != NULL){
-      gchar *basefilename=g_path_get_basename(basename);
-      fifoname=g_strdup_printf("%s/%s", fifo_directory, basefilename);
-      g_free(basename);
-    }
+  if (length > 0){
+    gchar *range_basename=g_strdup_printf("%s.%"G_GUINT64_FORMAT, basename, offset);
+    g_free(basename);
+    basename=range_basename;
+  }
+  fifoname=basename;
+  if (fifo_directory != NULL){
+    gchar *basefilename=g_path_get_basename(basename);
+    fifoname=g_strdup_printf("%s/%s", fifo_directory, basefilename);
+    g_free(basename);
+  }
 // This 2 lines simulates if a common file or a fifo file is present in the fifo dir:
 //    g_file_set_contents(fifoname, "   ",2,NULL );
 //    mkfifo(fifoname,0666);
-    if (g_file_test(fifoname, G_FILE_TEST_EXISTS)){
-      lstat(fifoname, &a);
-      g_message("FIFO file: %s", filename);
-      if ((a.st_mode & S_IFMT) == S_IFIFO){
-        g_warning("FIFO file found %s, removing and continuing", fifoname);
-        remove(fifoname);
-      }
-    }
-    if (mkfifo(fifoname,0666)){
-      g_critical("cannot create named pipe %s (%d)", fifoname, errno);
+  if (g_file_test(fifoname, G_FILE_TEST_EXISTS)){
+    lstat(fifoname, &a);
+    g_message("FIFO file: %s", filename);
+    if ((a.st_mode & S_IFMT) == S_IFIFO){
+      g_warning("FIFO file found %s, removing and continuing", fifoname);
+      remove(fifoname);
     }
+  }
+  if (mkfifo(fifoname,0666)){
+    g_critical("cannot create named pipe %s (%d)", fifoname, errno);
+  }
 
+  if (in >= 0){
+    child_proc = execute_fd_per_thread(in, fifoname, command);
+    close(in);
+  }else if (length > 0)
+    child_proc = execute_range_per_thread(filename, offset, length, fifoname, command);
+  else
     child_proc = execute_file_per_thread(filename, fifoname, command);
-    file=g_fopen(fifoname,type);
-
-    // Issue #2075: Unlink FIFO immediately after both ends are connected.
-    // Once fopen succeeds, both our process and the subprocess have the FIFO open.
-    // The pipe remains usable through the open file descriptors.
-    // This ensures automatic cleanup on crash (no stale FIFOs left behind).
-    if (file != NULL) {
-      g_unlink(fifoname);
+  file=g_fopen(fifoname,type);
+
+  // Issue #2075: Unlink FIFO immediately after both ends are connected.
+  // Once fopen succeeds, both our process and the subprocess have the FIFO open.
+  // The pipe remains usable through the open file descriptors.
+  // This ensures automatic cleanup on crash (no stale FIFOs left behind).
+  if (file != NULL) {
+    g_unlink(fifoname);
 //      m_remove0(fifo_directory,fifoname);
-    }
-    if (stream && !no_delete)
-      g_unlink(filename);
+  }
+  // The file of a range is removed when all its ranges were restored
+  if (stream && !no_delete && length == 0)
+    g_unlink(filename);
 /*    gchar *tmpbasename=g_path_get_basename(filename);
-    m_remove(directory,tmpbasename);
-    g_free(tmpbasename);
+  m_remove(directory,tmpbasename);
+  g_free(tmpbasename);
 */
-    g_mutex_lock(fifo_table_mutex);
-    struct fifo *f=g_hash_table_lookup(fifo_hash,file);
-    if (f!=NULL){
-      g_mutex_lock(f->mutex);
-      g_mutex_unlock(fifo_table_mutex);
-      f->pid = child_proc;
-      f->filename=g_strdup(filename);
-      f->stdout_filename=fifoname;
-      f->uses_decompressor=TRUE;
-    }else{
-      f=g_new0(struct fifo, 1);
-      f->mutex=g_mutex_new();
-      g_mutex_lock(f->mutex);
-      f->pid = child_proc;
-      f->filename=g_strdup(filename);
-      f->stdout_filename=fifoname;
-      f->uses_decompressor=TRUE;
-      g_hash_table_insert(fifo_hash,file,f);
-      g_mutex_unlock(fifo_table_mutex);
-    }
+  g_mutex_lock(fifo_table_mutex);
+  struct fifo *f=g_hash_table_lookup(fifo_hash,file);
+  if (f!=NULL){
+    g_mutex_lock(f->mutex);
+    g_mutex_unlock(fifo_table_mutex);
+    f->pid = child_proc;
+    f->filename=g_strdup(filename);
+    f->stdout_filename=fifoname;
+    f->uses_decompressor=TRUE;
+  }else{
+    f=g_new0(struct fifo, 1);
+    f->mutex=g_mutex_new();
+    g_mutex_lock(f->mutex);
+    f->pid = child_proc;
+    f->filename=g_strdup(filename);
+    f->stdout_filename=fifoname;
+    f->uses_decompressor=TRUE;
+    g_hash_table_insert(fifo_hash,file,f);
+    g_mutex_unlock(fifo_table_mutex);
+  }
+  return file;
+}
+
+// The decryption thread feeds the decompressor, or the caller when the file
+// is not compressed
+static
+FILE *open_encrypted(char *filename, const char *type){
+  FILE *file=NULL;
+  gchar *basename=NULL;
+  gchar **command=NULL;
+  if (!encryption_key_file)
+    m_critical("%s is encrypted, use --encryption-key-file", filename);
+  gchar *decrypted=g_strndup(filename, strlen(filename) - strlen(ENCRYPTION_EXTENSION));
+  int in=start_decryption(filename);
+  if (get_command_and_basename(decrypted, &command, &basename)){
+    file=open_decompressor(filename, type, command, basename, in, 0, 0);
+  }else{
+    g_free(basename);
+    file=fdopen(in, type);
+    if (stream && !no_delete)
+      g_unlink(filename);
+  }
+  g_free(decrypted);
+  return file;
+}
 
+FILE * myl_open(char *filename, const char *type){
+  FILE *file=NULL;
+  gchar *basename=NULL;
+  gchar **command=NULL;
+  struct stat a;
+  trace("myl_open %s", filename);
+  if (is_encrypted_filename(filename)){
+    file=open_encrypted(filename, type);
+  }else if (get_command_and_basename(filename, &command, &basename)){
+    file=open_decompressor(filename, type, command, basename, -1, 0, 0);
   }else{
     lstat(filename, &a);
     if ((a.st_mode & S_IFMT) == S_IFIFO){
@@ -176,6 +227,18 @@ FILE * myl_open(char *filename, const char *type){
   return file;
 }
 
+// Decompresses only length bytes of a compressed file, starting at offset
+FILE * myl_open_range(char *filename, guint64 offset, guint64 length){
+  gchar *basename=NULL;
+  gchar **command=NULL;
+  trace("myl_open_range %s at %"G_GUINT64_FORMAT, filename, offset);
+  if (!get_command_and_basename(filename, &command, &basename)){
+    g_free(basename);
+    return NULL;
+  }
+  return open_decompressor(filename, "r", command, basename, -1, offset, length);
+}
+
 void myl_close(const char *filename, FILE *file, gboolean rm){
   trace("myl_close %s", filename);
   g_mutex_lock(fifo_table_mutex);
@@ -291,7 +354,8 @@ regex_error:
             }
           }
         }
-        if (optimize_keys || skip_constraints || skip_indexes ){
+        // The tablespace has the indexes, so the table must be created with them
+        if ((optimize_keys || skip_constraints || skip_indexes) && !dbt->transportable_tablespace){
           GString *alter_table_statement=g_string_sized_new(512);
           GString *alter_table_constraint_statement=g_string_sized_new(512);
           g_string_set_size(alter_table_statement,0);
@@ -479,7 +543,7 @@ gboolean process_schema_sequence_filename(gchar *filename) {
     g_warning("It was not possible to process file: %s (3) because _database isn't found. We might renqueue it, take into account that restores without schema-create files are not supported",filename);
     return FALSE;
   }
-  if (!eval_table(_database->source_database, table_name, _conf->table_list_mutex)){
+  if (!eval_table(_database->source_database, table_name)){
     trace("File %s has been filtered out by table selection", filename);
     return FALSE;
   }
@@ -533,7 +597,7 @@ gboolean process_table_filename(char * filename){
   }
 
   struct database *_database=get_database(db_name,db_name);
-  if (!eval_table(_database->source_database, table_name, _conf->table_list_mutex)){
+  if (!eval_table(_database->source_database, table_name)){
     trace("Skipping table: `%s`.`%s`", _database->source_database, table_name);
     dbt=get_table(_database->database_name_in_filename, table_name);
     if (dbt){
@@ -546,9 +610,14 @@ gboolean process_table_filename(char * filename){
   }
 
   append_new_db_table(&dbt, _database, NULL, table_name, FALSE);//,0,NULL);
+  // The schema file and the first data file of a table can reach different
+  // file type threads at the same time
+  table_lock(dbt);
   if (dbt->schema_state<NOT_CREATED){
     dbt->schema_state=NOT_CREATED;
+    table_unlock(dbt);
   }else{
+    table_unlock(dbt);
     // parsing was already done
     trace("Processing table filename: %s was already done", filename);
     return FALSE;
@@ -703,7 +772,7 @@ void process_metadata_global_filename(gchar *file, GOptionContext * local_contex
             if (real_table_name != NULL)
               table_name_for_eval = real_table_name;
           }
-          if (!eval_table(_database->source_database, (gchar *)table_name_for_eval, _conf->table_list_mutex)){
+          if (!eval_table(_database->source_database, (gchar *)table_name_for_eval)){
             trace("Skipping metadata entry for `%s`.`%s` due to table filters", _database->source_database, table_name_for_eval);
             if (real_table_name) {
              g_free(real_table_name);
@@ -731,6 +800,11 @@ void process_metadata_global_filename(gchar *file, GOptionContext * local_contex
             ++sequences;
           }
           if (value) g_free(value);
+          value=get_value(kf, groups[j], "transportable_tablespace");
+          if (value != NULL && g_strcmp0(value, "1") == 0)
+            dbt->transportable_tablespace= TRUE;
+          g_free(value);
+          value=NULL;
           if (get_value(kf,groups[j],ROWS)){
             dbt->rows=g_ascii_strtoull(get_value(kf,groups[j],ROWS),NULL, 10);
           }
@@ -773,6 +847,38 @@ void process_metadata_global_filename(gchar *file, GOptionContext * local_contex
 
 }
 
+static
+GString *read_view_statement(gchar *filename){
+  FILE *infile;
+  gboolean eof = FALSE;
+  guint line=0;
+  GString *data=g_string_sized_new(512);
+  GString *statement=g_string_sized_new(512);
+  gchar *path=g_build_filename(directory, filename, NULL);
+  infile=myl_open(path,"r");
+  if (!infile) {
+    g_critical("cannot open view schema file %s (%d)", path, errno);
+    errors++;
+    g_free(path);
+    g_string_free(data, TRUE);
+    g_string_free(statement, TRUE);
+    return NULL;
+  }
+  while (eof == FALSE) {
+    if (read_data(infile, data, &eof, &line)) {
+      if (g_strrstr(&data->str[data->len >= 5 ? data->len - 5 : 0], ";\n")) {
+        update_definer(data, replace_definer_str, skip_definer);
+        g_string_append(statement, data->str);
+        g_string_set_size(data, 0);
+      }
+    }
+  }
+  myl_close(path, infile, FALSE);
+  g_free(path);
+  g_string_free(data, TRUE);
+  return statement;
+}
+
 gboolean process_schema_view_filename(gchar *filename) {
   gchar *database=NULL, *table_name=NULL;
   struct database *_database=NULL;
@@ -781,7 +887,7 @@ gboolean process_schema_view_filename(gchar *filename) {
     g_critical("Database is null on: %s",filename);
   }
   _database=get_database(database,database);
-  if (!eval_table(_database->source_database, table_name, _conf->table_list_mutex)){
+  if (!eval_table(_database->source_database, table_name)){
     trace("File %s has been filtered out by table selection", filename);
     return FALSE;
   }
@@ -789,8 +895,11 @@ gboolean process_schema_view_filename(gchar *filename) {
   append_new_db_table(&dbt,_database, NULL, table_name, TRUE);//,0, NULL);
 //  dbt->is_view=TRUE;
 //  dbt->checksum.skip_schema=  schema_checksums?skip_view_checksums:TRUE;
-  struct restore_job *rj = new_schema_restore_job(filename, JOB_RESTORE_SCHEMA_FILENAME, dbt, _database, NULL, VIEW);
-  g_async_queue_push(_conf->view_queue, new_control_job(JOB_RESTORE,rj,_database));
+  // The content is kept in memory, as it is needed to find the views that
+  // this view depends on, and in stream mode the file is gone once it is read
+  GString *statement=read_view_statement(filename);
+  struct restore_job *rj = new_schema_restore_job(filename, JOB_RESTORE_SCHEMA_FILENAME, dbt, _database, statement, VIEW);
+  add_view_to_graph(new_control_job(JOB_RESTORE,rj,_database), _database->source_database, table_name, statement);
   return TRUE;
 }
 
@@ -805,7 +914,7 @@ gboolean process_schema_post_filename(gchar *filename, enum restore_job_statemen
   }
   _database=get_database(database,database);
   if (table_name != NULL){ 
-	  if (!eval_table(_database->source_database, table_name, _conf->table_list_mutex)){
+	  if (!eval_table(_database->source_database, table_name)){
       trace("File %s has been filtered out by table selection", filename);
       return FALSE; 
     }
@@ -836,7 +945,9 @@ gint cmp_restore_job(gconstpointer rj1, gconstpointer rj2){
   return (sub_a > sub_b) ? 1 : (sub_a < sub_b) ? -1 : 0;
 }
 
-gboolean process_data_filename(char * filename){
+// filename is the data file, or the data file that a bundle segment replaces
+static
+gboolean enqueue_data_filename(char * filename, struct bundle_segment *segment){
   gchar *db_name, *table_name;
   // TODO: check if it is a data file
   // TODO: we need to count sections of the data file to determine if it is ok.
@@ -846,9 +957,16 @@ gboolean process_data_filename(char * filename){
     m_critical("It was not possible to process file: %s (3)",filename);
   }
 
+  // Data files of other databases are ignored by name, but not the segments
+  if (segment && source_db && g_strcmp0(db_name, source_db)){
+    g_free(segment);
+    return FALSE;
+  }
+
   struct database *_database=get_database(db_name,db_name);
-  if (!eval_table(_database->source_database, table_name, _conf->table_list_mutex)){
+  if (!eval_table(_database->source_database, table_name)){
     trace("Skipping table: `%s`.`%s`", _database->source_database, table_name);
+    g_free(segment);
     return FALSE;
   }
 
@@ -864,7 +982,11 @@ gboolean process_data_filename(char * filename){
     }
   }
 	if (!dbt->object_to_import.no_data){
-    struct restore_job *rj = new_data_restore_job( g_strdup(filename), JOB_RESTORE_FILENAME, dbt, part, sub_part);
+    struct restore_job *rj = new_data_restore_job( g_strdup(segment ? segment->bundle->filename : filename), JOB_RESTORE_FILENAME, dbt, part, sub_part);
+    if (segment){
+      g_atomic_int_inc(&(segment->bundle->remaining));
+      rj->data.drj->segment=segment;
+    }
     table_lock(dbt);
     g_atomic_int_add(&(dbt->remaining_jobs), 1);
     dbt->count++;
@@ -875,6 +997,164 @@ gboolean process_data_filename(char * filename){
     enqueue_table_if_ready(_conf, dbt);
 	}else{
     g_warning("Ignoring file %s on `%s`.`%s`",filename, dbt->database->source_database, dbt->table_filename);
+    g_free(segment);
 	}
   return TRUE;
 }
+
+static
+void release_bundle(struct bundle *bundle);
+
+static
+guint32 read_le32(const guchar *buffer){
+  guint32 value;
+  memcpy(&value, buffer, sizeof(value));
+  return GUINT32_FROM_LE(value);
+}
+
+// Files of mydumper --zstd-frame-size end with a zstd seek table. Returns the
+// compressed size of each frame, or NULL if the file has less than 2 frames.
+static
+GArray *read_zstd_seek_table(const gchar *filename){
+  gchar *path = g_build_filename(directory, filename, NULL);
+  FILE *infile=g_fopen(path,"r");
+  g_free(path);
+  if (!infile)
+    return NULL;
+  GArray *frames=NULL;
+  guchar footer[ZSTD_SEEK_TABLE_FOOTER_SIZE];
+  if (fseeko(infile, -ZSTD_SEEK_TABLE_FOOTER_SIZE, SEEK_END) ||
+      fread(footer, 1, ZSTD_SEEK_TABLE_FOOTER_SIZE, infile) != ZSTD_SEEK_TABLE_FOOTER_SIZE ||
+      read_le32(footer + 5) != ZSTD_SEEKABLE_MAGIC)
+    goto end;
+  guint32 n=read_le32(footer);
+  // Bit 7 of the descriptor is the checksum flag and bits 2 to 6 are reserved
+  guint entry_size=footer[4] & 0x80 ? 12 : 8;
+  if (n < 2 || footer[4] & 0x7C)
+    goto end;
+  guint table_size=n * entry_size + ZSTD_SEEK_TABLE_FOOTER_SIZE;
+  guchar *table=g_new(guchar, table_size + 8);
+  if (!fseeko(infile, -(off_t)(table_size + 8), SEEK_END) &&
+      fread(table, 1, table_size + 8, infile) == table_size + 8 &&
+      read_le32(table) == ZSTD_SKIPPABLE_MAGIC && read_le32(table + 4) == table_size){
+    frames=g_array_sized_new(FALSE, FALSE, sizeof(struct zstd_frame), n);
+    guint i;
+    for (i=0; i < n; i++){
+      struct zstd_frame frame={ read_le32(table + 8 + i*entry_size), read_le32(table + 12 + i*entry_size) };
+      g_array_append_val(frames, frame);
+    }
+  }
+  g_free(table);
+end:
+  fclose(infile);
+  return frames;
+}
+
+// Each frame of a file with a seek table is restored as a segment, so the
+// file is restored in parallel
+gboolean process_data_filename(char * filename){
+  GArray *frames=g_str_has_suffix(filename, ZSTD_EXTENSION) ? read_zstd_seek_table(filename) : NULL;
+  if (frames == NULL)
+    return enqueue_data_filename(filename, NULL);
+  struct bundle *bundle=g_new0(struct bundle, 1);
+  bundle->filename=g_strdup(filename);
+  bundle->remaining=1;
+  gboolean enqueued=FALSE;
+  guint64 offset=0;
+  guint i, segments=0;
+  for (i=0; i < frames->len; i++){
+    struct zstd_frame *frame=&g_array_index(frames, struct zstd_frame, i);
+    // A frame without data has only the headers
+    if (frame->decompressed_size > 0){
+      struct bundle_segment *segment=g_new0(struct bundle_segment, 1);
+      segment->bundle=bundle;
+      segment->offset=offset;
+      segment->length=frame->compressed_size;
+      if (enqueue_data_filename(filename, segment))
+        enqueued=TRUE;
+      segments++;
+    }
+    offset+=frame->compressed_size;
+  }
+  // The file itself is counted by the caller
+  if (segments > 1)
+    total_data_sql_files+=segments-1;
+  trace("%s has %u zstd frames", filename, frames->len);
+  g_array_free(frames, TRUE);
+  release_bundle(bundle);
+  return enqueued;
+}
+
+static
+void release_bundle(struct bundle *bundle){
+  if (!g_atomic_int_dec_and_test(&(bundle->remaining)))
+    return;
+  if (stream && !no_delete){
+    gchar *path = g_build_filename(directory, bundle->filename, NULL);
+    g_unlink(path);
+    g_free(path);
+  }
+  g_free(bundle->filename);
+  g_free(bundle);
+}
+
+void release_bundle_segment(struct bundle_segment *segment){
+  struct bundle *bundle=segment->bundle;
+  g_free(segment);
+  release_bundle(bundle);
+}
+
+// The index is at the end of the bundle and its last line has the offset
+// where the index starts. Each entry of the index is:
+// -- <offset> <length> <data filename>
+gboolean process_bundle_filename(char * filename){
+  gchar *path = g_build_filename(directory, filename, NULL);
+  FILE *infile=g_fopen(path,"r");
+  g_free(path);
+  if (!infile)
+    m_critical("cannot open bundle %s (%d)", filename, errno);
+
+  gchar trailer[BUNDLE_INDEX_TRAILER_SIZE + 1];
+  if (fseeko(infile, 0, SEEK_END) || ftello(infile) == 0){
+    // --build-empty-files keeps bundles without segments
+    fclose(infile);
+    return FALSE;
+  }
+  if (fseeko(infile, -(off_t)BUNDLE_INDEX_TRAILER_SIZE, SEEK_END) ||
+      fread(trailer, 1, BUNDLE_INDEX_TRAILER_SIZE, infile) != BUNDLE_INDEX_TRAILER_SIZE)
+    m_critical("Bundle %s has no index, it might be incomplete", filename);
+  trailer[BUNDLE_INDEX_TRAILER_SIZE]='\0';
+  if (!g_str_has_prefix(trailer, BUNDLE_INDEX_TRAILER))
+    m_critical("Bundle %s has no index, it might be incomplete", filename);
+  guint64 index_offset=g_ascii_strtoull(trailer + strlen(BUNDLE_INDEX_TRAILER), NULL, 10);
+  if (fseeko(infile, index_offset, SEEK_SET))
+    m_critical("Bundle %s has an invalid index offset %"G_GUINT64_FORMAT, filename, index_offset);
+
+  struct bundle *bundle=g_new0(struct bundle, 1);
+  bundle->filename=g_strdup(filename);
+  bundle->remaining=1;
+  GString *data=g_string_sized_new(256);
+  gboolean eof=FALSE, enqueued=FALSE;
+  guint line=0;
+  gchar *name=NULL;
+  while (!eof && read_data(infile, data, &eof, &line)){
+    if (g_str_has_prefix(data->str, BUNDLE_INDEX_TRAILER))
+      break;
+    if (data->len > 0 && g_strcmp0(data->str, BUNDLE_INDEX_HEADER)){
+      struct bundle_segment *segment=g_new0(struct bundle_segment, 1);
+      segment->bundle=bundle;
+      segment->offset=g_ascii_strtoull(data->str + 3, &name, 10);
+      segment->length=g_ascii_strtoull(name, &name, 10);
+      name=g_strchomp(g_strchug(name));
+      trace("Segment %s found in %s at %"G_GUINT64_FORMAT" with %"G_GUINT64_FORMAT" bytes", name, filename, segment->offset, segment->length);
+      if (enqueue_data_filename(name, segment))
+        enqueued=TRUE;
+      total_data_sql_files++;
+    }
+    g_string_set_size(data, 0);
+  }
+  g_string_free(data, TRUE);
+  fclose(infile);
+  release_bundle(bundle);
+  return enqueued;
+}
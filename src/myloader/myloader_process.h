@@ -33,10 +33,13 @@ void process_database_filename(char * filename);
 gboolean process_table_filename(char * filename);
 gboolean process_schema_post_filename(gchar *filename, enum restore_job_statement_type object);
 gboolean process_data_filename(char * filename);
+gboolean process_bundle_filename(char * filename);
+void release_bundle_segment(struct bundle_segment *segment);
 gboolean process_schema_view_filename(gchar *filename);
 gboolean process_schema_sequence_filename(gchar *filename);
 
 void process_metadata_global_filename(gchar *file, GOptionContext * local_context, gboolean is_global);
 FILE * myl_open(char *filename, const char *type);
+FILE * myl_open_range(char *filename, guint64 offset, guint64 length);
 void myl_close(const char *filename, FILE *file, gboolean rm);
 gint cmp_restore_job(gconstpointer rj1, gconstpointer rj2);
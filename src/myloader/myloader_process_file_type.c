@@ -32,7 +32,11 @@
 
 extern guint schema_counter;
 guint schema_processed_counter = 0;
-GAsyncQueue *process_file_type_queue = NULL;
+// One FIFO per file type, popped in enum order. This keeps the priority of
+// the previous sorted queue without the O(n) insert per file.
+static GQueue *process_file_type_bucket[FILENAME_ENDED+1];
+static GMutex *process_file_type_mutex = NULL;
+static GCond *process_file_type_cond = NULL;
 //GThread *stream_process_filename_thread = NULL;
 struct configuration *process_file_type_conf;
 guint process_file_type_num_threads=4;
@@ -80,8 +84,19 @@ void initialize_process_file_type(struct configuration *c){
   gchar *metadata_partial_path = g_build_filename(directory, "metadata.partial.0", NULL);
   if (!stream && g_file_test(metadata_partial_path, G_FILE_TEST_IS_REGULAR))
     process_file_type_num_threads = 1;
+  else if (!stream){
+    // Schema files are parsed here, so let it grow with the restore threads
+    guint cpu_count = g_get_num_processors();
+    process_file_type_num_threads = num_threads < cpu_count ? num_threads : cpu_count;
+    if (process_file_type_num_threads < 4)
+      process_file_type_num_threads = 4;
+  }
   g_free(metadata_partial_path);
-  process_file_type_queue = g_async_queue_new();
+  guint i;
+  for (i = 0; i <= FILENAME_ENDED; i++)
+    process_file_type_bucket[i] = g_queue_new();
+  process_file_type_mutex = g_mutex_new();
+  process_file_type_cond = g_cond_new();
   process_file_type_workers = g_new(GThread *, process_file_type_num_threads);
   guint n=0;
   for (n = 0; n < process_file_type_num_threads; n++) {
@@ -104,13 +119,27 @@ void file_type_free(struct filetype_item * fti){
   g_free(fti);
 }
 
-gint file_type_cmp (gconstpointer _a, gconstpointer _b, gpointer user_data){
-   struct filetype_item *a= (struct filetype_item *) _a;
-   struct filetype_item * b = (struct filetype_item *)_b;
-   (void)user_data;
-   gint result = (a->file_type > b->file_type) - (a->file_type < b->file_type);
-   trace("comparing %s <> %s = %d",ft2str(a->file_type),ft2str(b->file_type), result);
-   return result;
+static
+void file_type_queue_push(struct filetype_item *fti){
+  g_mutex_lock(process_file_type_mutex);
+  g_queue_push_tail(process_file_type_bucket[fti->file_type], fti);
+  g_cond_signal(process_file_type_cond);
+  g_mutex_unlock(process_file_type_mutex);
+}
+
+static
+struct filetype_item *file_type_queue_pop(){
+  struct filetype_item *fti=NULL;
+  guint i;
+  g_mutex_lock(process_file_type_mutex);
+  while (fti == NULL){
+    for (i = 0; i <= FILENAME_ENDED && fti == NULL; i++)
+      fti = g_queue_pop_head(process_file_type_bucket[i]);
+    if (fti == NULL)
+      g_cond_wait(process_file_type_cond, process_file_type_mutex);
+  }
+  g_mutex_unlock(process_file_type_mutex);
+  return fti;
 }
 
 void file_type_push( enum file_type ft, gchar *filename){
@@ -118,14 +147,14 @@ void file_type_push( enum file_type ft, gchar *filename){
   if (ft != FILENAME_ENDED) {
     note_restore_summary_file(filename);
   }
-  g_async_queue_push_sorted(process_file_type_queue, file_type_new(filename, ft), &file_type_cmp, NULL);
+  file_type_queue_push(file_type_new(filename, ft));
 }
 
 void *process_file_type_worker(void *data){
   (void) data;
   struct filetype_item* fti=NULL;
   while (TRUE){
-    fti = g_async_queue_pop(process_file_type_queue);
+    fti = file_type_queue_pop();
     trace("process_file_type_queue -> %s (%s)", fti->filename, ft2str(fti->file_type));
     switch (fti->file_type){
       case METADATA_GLOBAL:
@@ -162,6 +191,13 @@ void *process_file_type_worker(void *data){
           m_remove(directory,fti->filename);
         total_data_sql_files++;
         break;
+      case BUNDLE:
+        if (!no_data){
+          if (process_bundle_filename(fti->filename)) // each segment is added to the restore_job_list of its table
+            wake_data_threads();
+        }else
+          m_remove(directory,fti->filename);
+        break;
       case LOAD_DATA:
         // LOAD_DATA files are not processed/executed as the DATA filename has the execution statement
         release_load_data_as_it_is_close(fti->filename);
@@ -179,7 +215,10 @@ void *process_file_type_worker(void *data){
           process_schema_post_filename(fti->filename, POST); // pushed to post_queue
         break;
       case IGNORED:
-        g_warning("Filename %s has been ignored", fti->filename);
+        // The tablespace files are read when the table is imported
+        if (g_strcmp0(fti->filename, ZSTD_DICTIONARY_FILENAME) &&
+            !g_str_has_suffix(fti->filename, ".ibd") && !g_str_has_suffix(fti->filename, ".cfg"))
+          g_warning("Filename %s has been ignored", fti->filename);
         break;
       case RESUME:
         if (stream){
@@ -189,7 +228,7 @@ void *process_file_type_worker(void *data){
       case FILENAME_ENDED:
   //      schema_ended();
         trace("process_file_type_queue <- %s", ft2str(fti->file_type));
-        g_async_queue_push(process_file_type_queue,fti);
+        file_type_queue_push(fti);
         return NULL;
         break;
     }
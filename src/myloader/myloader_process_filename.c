@@ -65,7 +65,9 @@ void initialize_process_filename (struct configuration *c){
     process_filename_num_threads = 1;
   }else{
     guint cpu_count = g_get_num_processors();
-    process_filename_num_threads = cpu_count > 4 ? 4 : cpu_count;
+    process_filename_num_threads = num_threads < cpu_count ? num_threads : cpu_count;
+    if (process_filename_num_threads > 16)
+      process_filename_num_threads = 16;
     if (process_filename_num_threads < 1)
       process_filename_num_threads = 1;
   }
@@ -188,6 +190,9 @@ enum file_type get_file_type (const char * filename){
     return SCHEMA_CREATE;
   }
 
+  if (g_str_has_prefix(filename, BUNDLE_PREFIX) && g_str_has_suffix(filename, ".sql") && strchr(filename, '.') == strrchr(filename, '.'))
+    return BUNDLE;
+
   if (m_filename_has_suffix(filename, ".sql") )
     return DATA;
 
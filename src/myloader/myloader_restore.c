@@ -17,6 +17,7 @@
 
 #include <mysql.h>
 #include <errmsg.h>
+#include <mysqld_error.h>
 #include <glib.h>
 #include <glib/gstdio.h>
 #include <stdio.h>
@@ -25,6 +26,11 @@
 #include <fcntl.h>
 #include <poll.h>
 #include <sys/wait.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "myloader.h"
 #include "myloader_common.h"
@@ -39,6 +45,7 @@ extern gboolean dry_run;
 
 struct statement * new_statement();
 guint64 max_transaction_size=DEFAULT_MAX_TRANSACTION_SIZE;
+gboolean insert_as_load_data=FALSE;
 gboolean skip_definer = FALSE;
 gchar *replace_definer = NULL;
 GAsyncQueue *connection_pool = NULL;
@@ -164,6 +171,26 @@ void initialize_restore(){
     replace_definer_str=g_strdup_printf("DEFINER=%s",replace_definer);
 }
 
+// The character set and the sql_mode of a connection are queried again
+// after a new connection or a statement that could have changed them
+static
+void reset_connection_modes(struct connection_data *cd){
+  g_free(cd->character_set);
+  cd->character_set=NULL;
+  cd->strict_mode=FALSE;
+}
+
+static
+gboolean changes_connection_modes(GString *statement){
+  gsize i;
+  for (i=0; i<statement->len; i++)
+    if (!g_ascii_strncasecmp(statement->str + i, "NAMES", 5) ||
+        !g_ascii_strncasecmp(statement->str + i, "CHARACTER_SET_CLIENT", 20) ||
+        !g_ascii_strncasecmp(statement->str + i, "SQL_MODE", 8))
+      return TRUE;
+  return FALSE;
+}
+
 struct connection_data *new_connection_data(MYSQL *thrconn){
   struct connection_data *cd=g_new(struct connection_data,1);
   if (thrconn)
@@ -177,15 +204,153 @@ struct connection_data *new_connection_data(MYSQL *thrconn){
   cd->ready=g_async_queue_new();
   cd->queue=NULL;
   cd->in_use=g_mutex_new();
+  cd->insert_buffer=g_string_sized_new(65536);
+  cd->character_set=NULL;
+  cd->strict_mode=FALSE;
   trace("Executing set session");
   execute_gstring(cd->thrconn, set_session);
   g_async_queue_push(connection_pool,cd);
   return cd;
 }
+// Statements travel from the thread that reads a file to the connections
+// that it was granted and back, at least twice per statement. The rings
+// are lock-free bounded MPMC queues: a file has one reader but it can have
+// several connections. Threads only sleep, on a futex, when the ring is
+// empty or full. As a file never has more than 8 statements in flight
+// plus the CLOSE statements, the rings do not get full in practice.
+#define STATEMENT_RING_SIZE 64
+
+#ifdef __linux__
+static
+void ring_wait(gint *counter, gint value){
+  syscall(SYS_futex, counter, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+static
+void ring_wake(gint *counter){
+  syscall(SYS_futex, counter, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+#else
+static
+void ring_wait(gint *counter, gint value){
+  if (g_atomic_int_get(counter) == value)
+    g_usleep(50);
+}
+
+static
+void ring_wake(gint *counter){
+  (void) counter;
+}
+#endif
+
+static
+struct statement_ring *new_statement_ring(guint size){
+  struct statement_ring *ring=g_new0(struct statement_ring, 1);
+  guint i=0;
+  ring->cells=g_new(struct statement_ring_cell, size);
+  ring->mask=size-1;
+  for(i=0; i<size; i++){
+    ring->cells[i].sequence=i;
+    ring->cells[i].data=NULL;
+  }
+  return ring;
+}
+
+static
+gboolean statement_ring_try_push(struct statement_ring *ring, gpointer data){
+  struct statement_ring_cell *cell=NULL;
+  gint pos=g_atomic_int_get(&(ring->enqueue_pos));
+  gint diff=0;
+  while (1){
+    cell=&(ring->cells[(guint)pos & ring->mask]);
+    diff=(gint)((guint)g_atomic_int_get(&(cell->sequence)) - (guint)pos);
+    if (diff == 0){
+      if (g_atomic_int_compare_and_exchange(&(ring->enqueue_pos), pos, (gint)((guint)pos+1)))
+        break;
+      pos=g_atomic_int_get(&(ring->enqueue_pos));
+    }else if (diff < 0)
+      return FALSE;
+    else
+      pos=g_atomic_int_get(&(ring->enqueue_pos));
+  }
+  cell->data=data;
+  g_atomic_int_set(&(cell->sequence), (gint)((guint)pos+1));
+  return TRUE;
+}
+
+static
+gpointer statement_ring_try_pop(struct statement_ring *ring){
+  struct statement_ring_cell *cell=NULL;
+  gint pos=g_atomic_int_get(&(ring->dequeue_pos));
+  gint diff=0;
+  gpointer data=NULL;
+  while (1){
+    cell=&(ring->cells[(guint)pos & ring->mask]);
+    diff=(gint)((guint)g_atomic_int_get(&(cell->sequence)) - ((guint)pos+1));
+    if (diff == 0){
+      if (g_atomic_int_compare_and_exchange(&(ring->dequeue_pos), pos, (gint)((guint)pos+1)))
+        break;
+      pos=g_atomic_int_get(&(ring->dequeue_pos));
+    }else if (diff < 0)
+      return NULL;
+    else
+      pos=g_atomic_int_get(&(ring->dequeue_pos));
+  }
+  data=cell->data;
+  g_atomic_int_set(&(cell->sequence), (gint)((guint)pos+ring->mask+1));
+  return data;
+}
+
+// A waiter registers itself before checking the ring for the last time,
+// so a thread that changes the ring and finds no waiters can skip the
+// wake up syscall.
+static
+void statement_ring_push(struct statement_ring *ring, gpointer data){
+  gint popped=0;
+  if (!statement_ring_try_push(ring, data)){
+    g_atomic_int_inc(&(ring->push_waiters));
+    while(1){
+      popped=g_atomic_int_get(&(ring->popped));
+      if (statement_ring_try_push(ring, data))
+        break;
+      ring_wait(&(ring->popped), popped);
+    }
+    g_atomic_int_add(&(ring->push_waiters), -1);
+  }
+  g_atomic_int_inc(&(ring->pushed));
+  if (g_atomic_int_get(&(ring->pop_waiters)) > 0)
+    ring_wake(&(ring->pushed));
+}
+
+static
+gpointer statement_ring_pop(struct statement_ring *ring){
+  gint pushed=0;
+  gpointer data=statement_ring_try_pop(ring);
+  if (data == NULL){
+    g_atomic_int_inc(&(ring->pop_waiters));
+    while(1){
+      pushed=g_atomic_int_get(&(ring->pushed));
+      if ((data=statement_ring_try_pop(ring)) != NULL)
+        break;
+      ring_wait(&(ring->pushed), pushed);
+    }
+    g_atomic_int_add(&(ring->pop_waiters), -1);
+  }
+  g_atomic_int_inc(&(ring->popped));
+  if (g_atomic_int_get(&(ring->push_waiters)) > 0)
+    ring_wake(&(ring->popped));
+  return data;
+}
+
+static
+gint statement_ring_length(struct statement_ring *ring){
+  return (gint)((guint)g_atomic_int_get(&(ring->enqueue_pos)) - (guint)g_atomic_int_get(&(ring->dequeue_pos)));
+}
+
 struct io_restore_result *new_io_restore_result(){
   struct io_restore_result *iors=g_new(struct io_restore_result,1);
-  iors->result=g_async_queue_new();
-  iors->restore=g_async_queue_new();
+  iors->result=new_statement_ring(STATEMENT_RING_SIZE);
+  iors->restore=new_statement_ring(STATEMENT_RING_SIZE);
   return iors;
 }
 
@@ -237,6 +402,7 @@ void reconnect_connection_data(struct connection_data *cd){
   cd->thrconn=mysql_init(NULL);
   m_connect(cd->thrconn);
   cd->connection_id=mysql_thread_id(cd->thrconn);
+  reset_connection_modes(cd);
   execute_use(cd);
   execute_gstring(cd->thrconn, set_session);
 }
@@ -252,6 +418,7 @@ gboolean release_idle_connection_if_possible(){
     cd->thrconn = NULL;
     cd->connection_id = 0;
     cd->current_database = NULL;
+    reset_connection_modes(cd);
   }
 
   g_async_queue_push(connection_pool, cd);
@@ -366,6 +533,7 @@ void setup_connection(struct connection_data *cd, struct thread_data *td, struct
     m_connect(cd->thrconn);
     cd->connection_id = mysql_thread_id(cd->thrconn);
     cd->current_database = NULL;
+    reset_connection_modes(cd);
     execute_gstring(cd->thrconn, set_session);
   }
   trace("Thread %d: Connection %ld granted", td->thread_id, cd->connection_id);
@@ -416,8 +584,10 @@ void setup_connection(struct connection_data *cd, struct thread_data *td, struct
     m_query_warning(cd->thrconn, "START TRANSACTION", "START TRANSACTION failed");
 
   cd->queue = io_restore_result;
-  if (header)
+  if (header){
     execute_gstring(cd->thrconn,header);
+    reset_connection_modes(cd);
+  }
   g_async_queue_push(cd->ready, cd->queue);
 }
 
@@ -453,6 +623,323 @@ int m_commit_and_start_transaction(struct connection_data *cd, guint* query_coun
   return 0;
 }
 
+struct values_infile {
+  const gchar *start;
+  const gchar *end;
+  const gchar *position;
+};
+
+static
+int values_infile_init(void **ptr, const char *filename, void *userdata){
+  (void) filename;
+  struct values_infile *vi=userdata;
+  vi->position=vi->start;
+  *ptr=vi;
+  return 0;
+}
+
+static
+int values_infile_read(void *ptr, char *buf, unsigned int buf_len){
+  struct values_infile *vi=ptr;
+  unsigned int len=MIN(buf_len, (unsigned int)(vi->end - vi->position));
+  memcpy(buf, vi->position, len);
+  vi->position+=len;
+  return len;
+}
+
+static
+void values_infile_end(void *ptr){
+  (void) ptr;
+}
+
+static
+int values_infile_error(void *ptr, char *error_msg, unsigned int error_msg_len){
+  (void) ptr;
+  g_strlcpy(error_msg, "Not able to read the rows of the INSERT", error_msg_len);
+  return CR_UNKNOWN_ERROR;
+}
+
+// Returns the amount of rows in the VALUES list, or 0 if LOAD DATA is not
+// able to read it as it is. Each row must be on its own line and the values
+// must be quoted strings, numbers or NULL: hexadecimal, bit and introduced
+// literals or expressions are not interpreted by LOAD DATA.
+static
+guint count_values_rows(const gchar *c, const gchar *end){
+  guint rows=0;
+  while (c < end && g_ascii_isspace(*c))
+    c++;
+  while (c < end && *c == '('){
+    c++;
+    while (1){
+      if (c >= end)
+        return 0;
+      if (*c == '\''){
+        c++;
+        while (c < end){
+          if (*c == '\\')
+            c+=2;
+          else if (*c == '\n')
+            return 0;
+          else if (*c == '\'' && c + 1 < end && c[1] == '\'')
+            c+=2;
+          else if (*c == '\'')
+            break;
+          else
+            c++;
+        }
+        if (c >= end)
+          return 0;
+        c++;
+      }else if (end - c >= 4 && !strncmp(c, "NULL", 4)){
+        c+=4;
+      }else{
+        const gchar *token=c;
+        while (c < end && (g_ascii_isdigit(*c) || *c == '-' || *c == '+' || *c == '.' || *c == 'e' || *c == 'E'))
+          c++;
+        if (c == token)
+          return 0;
+      }
+      if (c < end && *c == ','){
+        c++;
+      }else if (c < end && *c == ')'){
+        c++;
+        break;
+      }else
+        return 0;
+    }
+    if (c >= end || *c != '\n')
+      return 0;
+    c++;
+    rows++;
+    if (c < end && *c == ',')
+      c++;
+    else
+      break;
+  }
+  while (c < end && (g_ascii_isspace(*c) || *c == ';'))
+    c++;
+  return c == end ? rows : 0;
+}
+
+// Triggers created on the table before the restore would fire for the
+// INSERT but could behave differently for LOAD DATA. The rows loaded can
+// only be rolled back when the engine of the table is transactional.
+static
+gboolean check_table_for_load_data(struct connection_data *cd, struct db_table *dbt, gboolean *is_transactional){
+  gboolean checked=FALSE, has_triggers=TRUE;
+  table_lock(dbt);
+  checked=dbt->load_data_checked;
+  has_triggers=dbt->has_triggers;
+  *is_transactional=dbt->is_transactional;
+  table_unlock(dbt);
+  if (checked)
+    return !has_triggers;
+  gsize database_length=strlen(dbt->database->target_database), table_length=strlen(dbt->source_table_name);
+  gchar *database=g_new(gchar, database_length * 2 + 1), *table=g_new(gchar, table_length * 2 + 1);
+  mysql_real_escape_string(cd->thrconn, database, dbt->database->target_database, database_length);
+  mysql_real_escape_string(cd->thrconn, table, dbt->source_table_name, table_length);
+  gchar *query=g_strdup_printf("SELECT EXISTS(SELECT 1 FROM information_schema.TRIGGERS WHERE EVENT_OBJECT_SCHEMA='%s' AND EVENT_OBJECT_TABLE='%s'), "
+                               "IFNULL(e.TRANSACTIONS,'NO')='YES' FROM information_schema.TABLES t LEFT JOIN information_schema.ENGINES e ON e.ENGINE=t.ENGINE "
+                               "WHERE t.TABLE_SCHEMA='%s' AND t.TABLE_NAME='%s'", database, table, database, table);
+  struct M_ROW *mr=m_store_result_row(cd->thrconn, query, m_warning, m_message, "Not able to check the triggers of %s.%s", dbt->database->target_database, dbt->source_table_name, NULL);
+  has_triggers=mr->row == NULL || mr->row[0] == NULL || g_strcmp0(mr->row[0], "0");
+  *is_transactional=mr->row != NULL && !g_strcmp0(mr->row[1], "1");
+  m_store_result_row_free(mr);
+  g_free(query);
+  g_free(database);
+  g_free(table);
+  table_lock(dbt);
+  dbt->has_triggers=has_triggers;
+  dbt->is_transactional=*is_transactional;
+  dbt->load_data_checked=TRUE;
+  table_unlock(dbt);
+  if (has_triggers)
+    trace("Thread %ld: %s.%s has triggers, its INSERT statements are not converted to LOAD DATA", cd->thread_id, dbt->database->target_database, dbt->source_table_name);
+  return !has_triggers;
+}
+
+// The character set of the LOAD DATA is the one of the connection, and in
+// strict mode the warnings of LOAD DATA would have been errors on INSERT
+static
+gboolean refresh_connection_modes(struct connection_data *cd){
+  if (cd->character_set != NULL)
+    return TRUE;
+  struct M_ROW *mr=m_store_result_row(cd->thrconn, "SELECT @@character_set_client, @@sql_mode", m_warning, m_message, "Not able to get the character set of the connection", NULL);
+  if (mr->row && mr->row[0]){
+    cd->character_set=g_strdup(mr->row[0]);
+    cd->strict_mode=mr->row[1] && (strstr(mr->row[1], "STRICT_TRANS_TABLES") || strstr(mr->row[1], "STRICT_ALL_TABLES"));
+  }
+  m_store_result_row_free(mr);
+  return cd->character_set != NULL;
+}
+
+// Returns the end of the line of the n-th row from c, rows can't have new
+// lines inside as count_values_rows checked
+static
+const gchar *skip_values_rows(const gchar *c, const gchar *end, guint n){
+  while (c < end && *c != '(')
+    c++;
+  for (; n > 0 && c != NULL && c < end; n--){
+    c=memchr(c, '\n', end - c);
+    if (c != NULL)
+      c++;
+  }
+  return c != NULL ? c : end;
+}
+
+#define LOAD_DATA_SAVEPOINT "myloader_load_data"
+
+static
+void rollback_load_data(struct connection_data *cd){
+  if (dry_run)
+    return;
+  if (cd->transaction)
+    m_query_warning(cd->thrconn, "ROLLBACK TO SAVEPOINT " LOAD_DATA_SAVEPOINT, "Not able to roll back the LOAD DATA", NULL);
+  else
+    m_query_warning(cd->thrconn, "ROLLBACK", "Not able to roll back the LOAD DATA", NULL);
+}
+
+// Sends the rows of the INSERT to LOAD DATA LOCAL INFILE, reading them from
+// the statement through a local infile handler. Like restore_insert, each
+// LOAD DATA has at most --rows rows. When there are several of them or the
+// sql_mode is strict, the rows are loaded inside a transaction, or after a
+// savepoint, so they can be rolled back. It returns -1 when the statement
+// must be executed as an INSERT.
+static
+int restore_insert_as_load_data(struct connection_data *cd, struct thread_data*td,
+                  GString *data, guint *query_counter, guint offset_line, struct db_table *dbt)
+{
+  const gchar *duplicates=NULL, *c=NULL, *values=NULL;
+  if (g_str_has_prefix(data->str, "INSERT IGNORE INTO ")){
+    duplicates=" IGNORE";
+    c=data->str + 19;
+  }else if (g_str_has_prefix(data->str, "INSERT INTO ")){
+    duplicates="";
+    c=data->str + 12;
+  }else
+    return -1;
+
+  // The table name is quoted, and it can be followed by the column list
+  const gchar *table_start=c;
+  if (*c != identifier_quote_character)
+    return -1;
+  for (c++; *c; c++){
+    if (*c == identifier_quote_character){
+      if (c[1] != identifier_quote_character)
+        break;
+      c++;
+    }
+  }
+  if (*c == '\0')
+    return -1;
+  c++;
+  values=strstr(c, "VALUES");
+  if (values == NULL)
+    return -1;
+  const gchar *rows_start=values + 6, *rows_end=data->str + data->len;
+  guint current_rows=count_values_rows(rows_start, rows_end);
+  gboolean is_transactional=FALSE;
+  if (current_rows == 0 || !check_table_for_load_data(cd, dbt, &is_transactional) || !refresh_connection_modes(cd))
+    return -1;
+  guint statements=rows > 0 ? (current_rows + rows - 1) / rows : 1;
+  gboolean needs_rollback=statements > 1 || cd->strict_mode;
+  if (needs_rollback && !is_transactional)
+    return -1;
+
+  gchar *table=g_strndup(table_start, c - table_start);
+  gchar *columns=g_strstrip(g_strndup(c, values - c));
+  GString *load_data=cd->insert_buffer;
+  int tr=0;
+  guint loaded_rows=0, chunk_rows=0, current_offset_line=offset_line - 1;
+  const gchar *chunk_start=rows_start, *chunk_end=NULL;
+  guint64 affected_rows=0;
+  if (cd->transaction && max_transaction_size * 1024 * 1024 < data->len)
+    tr+=m_commit_and_start_transaction(cd,query_counter);
+  if (!dry_run && needs_rollback && m_query_warning(cd->thrconn, cd->transaction ? "SAVEPOINT " LOAD_DATA_SAVEPOINT : "START TRANSACTION", "Not able to start the LOAD DATA", NULL)){
+    g_free(table);
+    g_free(columns);
+    return -1;
+  }
+  while (loaded_rows < current_rows){
+    chunk_rows=rows > 0 ? MIN(rows, current_rows - loaded_rows) : current_rows;
+    chunk_end=loaded_rows + chunk_rows == current_rows ? rows_end : skip_values_rows(chunk_start, rows_end, chunk_rows);
+    offset_line=current_offset_line + 1;
+    current_offset_line+=chunk_rows;
+    g_string_printf(load_data, "/* Completed: %"G_GUINT64_FORMAT"%% */ LOAD DATA LOCAL INFILE 'values'%s INTO TABLE %s CHARACTER SET %s "
+        "FIELDS TERMINATED BY ',' OPTIONALLY ENCLOSED BY '\\'' ESCAPED BY '\\\\' LINES STARTING BY '(' TERMINATED BY ')\\n' %s",
+        dbt->rows>0?dbt->rows_inserted*100/dbt->rows:0, duplicates, table, cd->character_set, columns);
+    struct values_infile vi={chunk_start, chunk_end, chunk_start};
+    mysql_set_local_infile_handler(cd->thrconn, &values_infile_init, &values_infile_read, &values_infile_end, &values_infile_error, &vi);
+    if (!dry_run && mysql_real_query(cd->thrconn, load_data->str, load_data->len)){
+      guint error_number=mysql_errno(cd->thrconn);
+      mysql_set_local_infile_default(cd->thrconn);
+      if (error_number == ER_NOT_ALLOWED_COMMAND
+#ifdef ER_CLIENT_LOCAL_FILES_DISABLED
+          || error_number == ER_CLIENT_LOCAL_FILES_DISABLED
+#endif
+         ){
+        g_warning("Thread %ld: LOAD DATA LOCAL INFILE is not allowed, INSERT statements will not be converted: %s", cd->thread_id, mysql_error(cd->thrconn));
+        insert_as_load_data=FALSE;
+      }else
+        trace("Thread %ld: LOAD DATA failed between lines %d and %d, executing the INSERT: %s", cd->thread_id, offset_line, current_offset_line, mysql_error(cd->thrconn));
+      if (needs_rollback)
+        rollback_load_data(cd);
+      g_free(table);
+      g_free(columns);
+      return -1;
+    }
+    mysql_set_local_infile_default(cd->thrconn);
+    if (!dry_run && cd->strict_mode && mysql_warning_count(cd->thrconn)){
+      trace("Thread %ld: LOAD DATA returned warnings between lines %d and %d in strict mode, executing the INSERT", cd->thread_id, offset_line, current_offset_line);
+      rollback_load_data(cd);
+      g_free(table);
+      g_free(columns);
+      return -1;
+    }
+    affected_rows=dry_run ? chunk_rows : mysql_affected_rows(cd->thrconn);
+    // LOAD DATA LOCAL skips the duplicated rows instead of failing like INSERT,
+    // which reports the error when the rows can be rolled back
+    if (*duplicates == '\0' && affected_rows != chunk_rows && !should_ignore_error_code(ER_DUP_ENTRY)){
+      if (needs_rollback){
+        trace("Thread %ld: LOAD DATA skipped duplicated rows between lines %d and %d, executing the INSERT", cd->thread_id, offset_line, current_offset_line);
+        rollback_load_data(cd);
+        g_free(table);
+        g_free(columns);
+        return -1;
+      }
+      emit_restore_file_event(G_LOG_LEVEL_CRITICAL,
+                              "rows skipped by load data",
+                              "restore_insert", "restore_data", "failed",
+                              td, cd, NULL, offset_line, current_offset_line,
+                              ER_DUP_ENTRY);
+      g_error("Thread %d with connection %ld: %"G_GUINT64_FORMAT" of %u rows were loaded between lines: %d and %d, duplicated rows were found",td->thread_id, cd->connection_id, affected_rows, chunk_rows, offset_line,current_offset_line);
+    }
+    if (!dry_run && mysql_warning_count(cd->thrconn)){
+      emit_restore_file_event(G_LOG_LEVEL_WARNING,
+                              "insert warnings found",
+                              "restore_insert", "restore_data", "warning",
+                              td, cd, NULL, offset_line, current_offset_line,
+                              mysql_warning_count(cd->thrconn));
+      g_warning("Thread %d with connection %ld: Warnings found during LOAD DATA between lines: %d and %d: %s",td->thread_id, cd->connection_id, offset_line,current_offset_line, show_warnings_if_possible(cd->thrconn));
+      detailed_errors.data_warnings+=mysql_warning_count(cd->thrconn);
+    }
+    loaded_rows+=chunk_rows;
+    chunk_start=chunk_end;
+  }
+  g_free(table);
+  g_free(columns);
+  if (!dry_run && needs_rollback && !cd->transaction && m_query_warning(cd->thrconn, "COMMIT", "Not able to commit the LOAD DATA", NULL))
+    tr++;
+  *query_counter=*query_counter+statements;
+  g_usleep(throttle_time);
+  table_lock(dbt);
+  dbt->rows_inserted+=current_rows;
+  table_unlock(dbt);
+  if (cd->transaction && *query_counter >= commit_count)
+    tr+=m_commit_and_start_transaction(cd,query_counter);
+  return tr;
+}
+
 static
 int restore_insert(struct connection_data *cd, struct thread_data*td,
                   GString *data, guint *query_counter, guint offset_line, struct db_table *dbt)
@@ -463,7 +950,6 @@ int restore_insert(struct connection_data *cd, struct thread_data*td,
   next_line += 6;  // Skip past "VALUES"
 
   guint prefix_len = next_line - data->str;
-  char *insert_statement_prefix=g_strndup(data->str, prefix_len);
   int r=0;
   guint tr=0,current_offset_line=offset_line-1;
   gchar *current_line=next_line;
@@ -475,15 +961,18 @@ int restore_insert(struct connection_data *cd, struct thread_data*td,
   // Perf: Use memchr instead of g_strstr_len for newline search (SIMD-optimized)
   next_line = (remaining > 0) ? memchr(current_line, '\n', remaining) : NULL;
 
-  GString * new_insert=g_string_sized_new(prefix_len + 4096);  // Larger initial size
+  GString * new_insert=cd->insert_buffer;
+  gchar completed[48];
   guint current_rows=0;
   guint64 transaction_size=0;
   do {
     current_rows=0;
+    // g_string_printf() allocates a temporary string on every call
     g_string_set_size(new_insert, 0);
-    g_string_printf(new_insert,"/* Completed: %"G_GUINT64_FORMAT"%% */ ", dbt->rows>0?dbt->rows_inserted*100/dbt->rows:0);
+    g_string_append_len(new_insert, completed,
+        g_snprintf(completed, sizeof(completed), "/* Completed: %"G_GUINT64_FORMAT"%% */ ", dbt->rows>0?dbt->rows_inserted*100/dbt->rows:0));
     // Perf: Use append_len with known prefix length
-    g_string_append_len(new_insert, insert_statement_prefix, prefix_len);
+    g_string_append_len(new_insert, data->str, prefix_len);
     guint line_len=0;
     do {
       // Perf: Direct append without g_strndup + strlen + g_free
@@ -537,8 +1026,6 @@ int restore_insert(struct connection_data *cd, struct thread_data*td,
     current_line++; // remove trailing ,
   } while (next_line != NULL);
   cd=NULL;
-  g_string_free(new_insert,TRUE);
-  g_free(insert_statement_prefix);
   return r;
 }
 
@@ -554,18 +1041,20 @@ void *restore_thread(MYSQL *thrconn){
     if (cd->queue->restore == NULL)
       break;
     while(1) {
-      ir=g_async_queue_pop(cd->queue->restore);
+      ir=statement_ring_pop(cd->queue->restore);
       if (ir->kind_of_statement == CLOSE){
         trace("Releasing connection: %ld", cd->connection_id);
         if (cd->transaction && query_counter > 0)
           m_commit(cd);
-        g_async_queue_push(cd->queue->result,ir);
+        statement_ring_push(cd->queue->result, ir);
         cd->queue=NULL;
         ir=NULL;
         break;
       }
       if (ir->kind_of_statement==INSERT){
-        ir->result=restore_insert(cd, ir->td, ir->buffer, &query_counter,ir->preline, ir->dbt);
+        ir->result=insert_as_load_data ? restore_insert_as_load_data(cd, ir->td, ir->buffer, &query_counter, ir->preline, ir->dbt) : -1;
+        if (ir->result < 0)
+          ir->result=restore_insert(cd, ir->td, ir->buffer, &query_counter,ir->preline, ir->dbt);
         if (ir->result>0){
           ir->error=g_strdup(mysql_error(cd->thrconn));
           ir->error_number=mysql_errno(cd->thrconn);
@@ -590,14 +1079,16 @@ void *restore_thread(MYSQL *thrconn){
             }
           }
         }
-        g_async_queue_push(cd->queue->result,ir);
+        statement_ring_push(cd->queue->result, ir);
       }else{
+        if (insert_as_load_data && changes_connection_modes(ir->buffer))
+          reset_connection_modes(cd);
         ir->result=restore_data_in_gstring_by_statement(cd, ir->buffer, ir->is_schema, &query_counter, ir->preline, 0); //current_offset_line);
         if (ir->result>0){
           ir->error=g_strdup(mysql_error(cd->thrconn));
           ir->error_number=mysql_errno(cd->thrconn);
         }
-        g_async_queue_push(cd->queue->result,ir);
+        statement_ring_push(cd->queue->result, ir);
       }
     }
     trace("Returning connection to pool: %ld", cd->connection_id);
@@ -702,10 +1193,9 @@ struct statement * new_statement(){
   return stmt;
 }
 
-void assign_statement(struct statement *ir, struct thread_data*td, struct db_table * dbt, gchar *stmt, guint preline, gboolean is_schema, enum kind_of_statement kind_of_statement){
+static
+void set_statement(struct statement *ir, struct thread_data*td, struct db_table * dbt, guint preline, gboolean is_schema, enum kind_of_statement kind_of_statement){
   initialize_statement(ir);
-  g_assert(stmt); 
-  g_string_assign(ir->buffer,stmt);
   ir->preline=preline;
   ir->is_schema=is_schema;
   ir->kind_of_statement=kind_of_statement;
@@ -713,9 +1203,28 @@ void assign_statement(struct statement *ir, struct thread_data*td, struct db_tab
   ir->td=td;
 }
 
+void assign_statement(struct statement *ir, struct thread_data*td, struct db_table * dbt, gchar *stmt, guint preline, gboolean is_schema, enum kind_of_statement kind_of_statement){
+  g_assert(stmt); 
+  g_string_assign(ir->buffer,stmt);
+  set_statement(ir, td, dbt, preline, is_schema, kind_of_statement);
+}
 
-guint process_result_vstatement_pop(GAsyncQueue * get_insert_result_queue, struct statement **ir, void log_fun(const char *, ...) , const char *fmt, va_list args, void * g_async_queue_pop_fun(GAsyncQueue *) ){
-  *ir=g_async_queue_pop_fun(get_insert_result_queue);
+// The statement takes the buffer that was read from the file and the
+// caller keeps reading on the buffer that the statement had. Buffers move
+// between the files and the statements of free_results_queue, so once
+// they grew to the size of the statements, nothing is allocated or copied.
+static
+void swap_statement_buffer(struct statement *ir, struct thread_data*td, struct db_table * dbt, GString **data, guint preline, gboolean is_schema, enum kind_of_statement kind_of_statement){
+  GString *buffer=ir->buffer;
+  ir->buffer=*data;
+  g_string_set_size(buffer, 0);
+  *data=buffer;
+  set_statement(ir, td, dbt, preline, is_schema, kind_of_statement);
+}
+
+
+guint process_result_vstatement_pop(struct statement_ring * get_insert_result_queue, struct statement **ir, void log_fun(const char *, ...) , const char *fmt, va_list args, gpointer statement_ring_pop_fun(struct statement_ring *) ){
+  *ir=statement_ring_pop_fun(get_insert_result_queue);
   if (*ir==NULL)
     return 0;
   if ((*ir)->kind_of_statement!=CLOSE && (*ir)->result>0){
@@ -726,11 +1235,11 @@ guint process_result_vstatement_pop(GAsyncQueue * get_insert_result_queue, struc
   return (*ir)->result;
 }
 
-guint process_result_vstatement(GAsyncQueue * get_insert_result_queue, struct statement **ir, void log_fun(const char *, ...) , const char *fmt, va_list args){
-  return process_result_vstatement_pop(get_insert_result_queue,ir,log_fun,fmt,args,g_async_queue_pop);
+guint process_result_vstatement(struct statement_ring * get_insert_result_queue, struct statement **ir, void log_fun(const char *, ...) , const char *fmt, va_list args){
+  return process_result_vstatement_pop(get_insert_result_queue,ir,log_fun,fmt,args,statement_ring_pop);
 }
 
-guint process_result_statement(GAsyncQueue * get_insert_result_queue, struct statement **ir, void log_fun(const char *, ...) , const char *fmt, ...){
+guint process_result_statement(struct statement_ring * get_insert_result_queue, struct statement **ir, void log_fun(const char *, ...) , const char *fmt, ...){
   va_list    args;
   va_start(args, fmt);
   guint r=process_result_vstatement(get_insert_result_queue,ir, log_fun, fmt, args);
@@ -759,8 +1268,8 @@ int restore_data_from_mysqldump_file(struct thread_data *td, const char *filenam
   }
   guint r=0;
   struct connection_data *cd=wait_for_available_restore_thread(td, !is_schema && (commit_count > 1), use_database );
-  g_assert(g_async_queue_length(cd->queue->restore)<=0);
-  g_assert(g_async_queue_length(cd->queue->result)<=0);
+  g_assert(statement_ring_length(cd->queue->restore)<=0);
+  g_assert(statement_ring_length(cd->queue->result)<=0);
   guint i=0;
   struct statement *ir=g_async_queue_pop(free_results_queue);
   gboolean results_added=FALSE;
@@ -774,8 +1283,8 @@ int restore_data_from_mysqldump_file(struct thread_data *td, const char *filenam
         g_string_set_size(data, 0);
       }else if (g_strrstr(&data->str[data->len >= 5 ? data->len - 5 : 0], delimiter)) {
         update_definer(data, replace_definer_str, skip_definer);
-        assign_statement(ir,td, td->dbt,data->str, preline, is_schema, OTHER);
-        g_async_queue_push(cd->queue->restore,ir);
+        swap_statement_buffer(ir,td, td->dbt, &data, preline, is_schema, OTHER);
+        statement_ring_push(cd->queue->restore, ir);
         ir=NULL;
         process_result_statement(cd->queue->result, &ir, m_critical, "(2)Error occurs processing file %s", filename);
         r|= ir->result;
@@ -808,7 +1317,7 @@ int restore_data_from_mysqldump_file(struct thread_data *td, const char *filenam
     }
   }
   for(;td->granted_connections>0;td->granted_connections--){
-    g_async_queue_push(queue->restore,&release_connection_statement);
+    statement_ring_push(queue->restore, &release_connection_statement);
     process_result_statement(queue->result, &ir, m_critical, "(2)Error occurs processing file %s", filename);
     g_assert(ir->kind_of_statement==CLOSE);
   }
@@ -822,37 +1331,24 @@ int restore_data_from_mysqldump_file(struct thread_data *td, const char *filenam
 }
 
 
-int restore_data_from_mydumper_file(struct thread_data *td, const char *filename, gboolean is_schema, struct database *use_database){
-
-  FILE *infile=NULL;
+// end is the offset where the statements stop, 0 reads until the end of file
+static
+int restore_data_from_mydumper_infile(struct thread_data *td, const char *filename, FILE *infile, gboolean is_schema, struct database *use_database, guint64 end){
   gboolean eof = FALSE;
   GString *data = g_string_sized_new(is_schema ? 4096 : 65536);
   guint line=0,preline=0;
-  gchar *path = g_build_filename(directory, filename, NULL);
-  infile=myl_open(path,"r");
-
-  g_log_set_always_fatal(G_LOG_LEVEL_ERROR|G_LOG_LEVEL_CRITICAL);
-
-  if (!infile) {
-    emit_restore_file_event(G_LOG_LEVEL_CRITICAL, "cannot open restore file",
-                            "restore_file", is_schema ? "restore_schema_file" : "restore_data_file",
-                            "failed", td, NULL, filename, 0, 0, errno);
-    g_critical("cannot open file %s (%d)", filename, errno);
-    errors++;
-    return 1;
-  }
   guint r=0;
   gchar *load_data_filename=NULL;
   gchar *load_data_fifo_filename=NULL;
   gchar *new_load_data_fifo_filename=NULL;
   struct connection_data *cd=wait_for_available_restore_thread(td, !is_schema && (commit_count > 1), use_database );
-  g_assert(g_async_queue_length(cd->queue->restore)<=0);
-  g_assert(g_async_queue_length(cd->queue->result)<=0);
+  g_assert(statement_ring_length(cd->queue->restore)<=0);
+  g_assert(statement_ring_length(cd->queue->result)<=0);
   guint i=0;
   struct statement *ir=g_async_queue_pop(free_results_queue);
   gboolean results_added=FALSE;
   GString *header=g_string_sized_new(256);
-  while (eof == FALSE) {
+  while (eof == FALSE && (end == 0 || (guint64)ftello(infile) < end)) {
     if (read_data(infile, data, &eof, &line)) {
       if (g_strrstr(&data->str[data->len >= 5 ? data->len - 5 : 0], ";\n")) {
         if (g_str_has_prefix(data->str,"CREATE")){
@@ -868,11 +1364,11 @@ int restore_data_from_mydumper_file(struct thread_data *td, const char *filename
             struct statement * other_ir=NULL;
             for(i=0;i<7;i++){
               other_ir=g_async_queue_pop(free_results_queue);
-              g_async_queue_push(cd->queue->result,initialize_statement(other_ir));
+              statement_ring_push(cd->queue->result, initialize_statement(other_ir));
             }
           } 
-          assign_statement(ir, td, td->dbt, data->str, preline, FALSE, INSERT);
-          g_async_queue_push(cd->queue->restore, ir);
+          swap_statement_buffer(ir, td, td->dbt, &data, preline, FALSE, INSERT);
+          statement_ring_push(cd->queue->restore, ir);
           ir=NULL;
           process_result_statement(cd->queue->result, &ir, m_critical, "(2)Error occurs processing file %s", filename);
         }else if (g_strrstr_len(data->str,10,"LOAD DATA ")){
@@ -928,8 +1424,8 @@ int restore_data_from_mydumper_file(struct thread_data *td, const char *filename
 //              g_free(fifo_name);
           }
 
-          assign_statement(ir, td, td->dbt, data->str, preline, FALSE, OTHER);
-          g_async_queue_push(cd->queue->restore,ir);
+          swap_statement_buffer(ir, td, td->dbt, &data, preline, FALSE, OTHER);
+          statement_ring_push(cd->queue->restore, ir);
 
           /*
           // Issue #2075: Schedule background thread to unlink FIFO after MySQL connects
@@ -974,8 +1470,8 @@ int restore_data_from_mydumper_file(struct thread_data *td, const char *filename
           }else{
             header=NULL;
           }
-          assign_statement(ir, td, td->dbt, data->str, preline, is_schema, OTHER);
-          g_async_queue_push(cd->queue->restore,ir);
+          swap_statement_buffer(ir, td, td->dbt, &data, preline, is_schema, OTHER);
+          statement_ring_push(cd->queue->restore, ir);
           ir=NULL;
           process_result_statement(cd->queue->result, &ir, m_critical, "(2)Error occurs processing file %s", filename);
         }
@@ -1011,7 +1507,7 @@ STMT_IGNORED:
     }
   }
   for(;td->granted_connections>0;td->granted_connections--){
-    g_async_queue_push(queue->restore,&release_connection_statement);
+    statement_ring_push(queue->restore, &release_connection_statement);
     process_result_statement(queue->result, &ir, m_critical, "(2)Error occurs processing file %s", filename);
     g_assert(ir->kind_of_statement==CLOSE);
   }
@@ -1019,12 +1515,70 @@ STMT_IGNORED:
 
   g_string_free(data, TRUE);
   g_free(load_data_filename);
+  return r;
+}
+
+int restore_data_from_mydumper_file(struct thread_data *td, const char *filename, gboolean is_schema, struct database *use_database){
+  gchar *path = g_build_filename(directory, filename, NULL);
+  FILE *infile=myl_open(path,"r");
 
+  g_log_set_always_fatal(G_LOG_LEVEL_ERROR|G_LOG_LEVEL_CRITICAL);
+
+  if (!infile) {
+    emit_restore_file_event(G_LOG_LEVEL_CRITICAL, "cannot open restore file",
+                            "restore_file", is_schema ? "restore_schema_file" : "restore_data_file",
+                            "failed", td, NULL, filename, 0, 0, errno);
+    g_critical("cannot open file %s (%d)", filename, errno);
+    errors++;
+    g_free(path);
+    return 1;
+  }
+  int r=restore_data_from_mydumper_infile(td, filename, infile, is_schema, use_database, 0);
   myl_close(filename, infile, TRUE);
   g_free(path);
   return r;
 }
 
+// Bundles are not compressed, so the segment is read directly from its offset.
+// A zstd frame is decompressed by itself.
+int restore_data_from_segment(struct thread_data *td, const char *filename, guint64 offset, guint64 length, struct database *use_database){
+  gchar *path = g_build_filename(directory, filename, NULL);
+  if (g_str_has_suffix(filename, ZSTD_EXTENSION)){
+    FILE *frame=myl_open_range(path, offset, length);
+    g_free(path);
+    g_log_set_always_fatal(G_LOG_LEVEL_ERROR|G_LOG_LEVEL_CRITICAL);
+    if (!frame) {
+      emit_restore_file_event(G_LOG_LEVEL_CRITICAL, "cannot open restore file",
+                              "restore_file", "restore_data_file",
+                              "failed", td, NULL, filename, 0, 0, errno);
+      g_critical("cannot open file %s at %"G_GUINT64_FORMAT" (%d)", filename, offset, errno);
+      errors++;
+      return 1;
+    }
+    int r=restore_data_from_mydumper_infile(td, filename, frame, FALSE, use_database, 0);
+    myl_close(filename, frame, FALSE);
+    return r;
+  }
+  FILE *infile=g_fopen(path,"r");
+  g_free(path);
+
+  g_log_set_always_fatal(G_LOG_LEVEL_ERROR|G_LOG_LEVEL_CRITICAL);
+
+  if (!infile || fseeko(infile, offset, SEEK_SET)) {
+    emit_restore_file_event(G_LOG_LEVEL_CRITICAL, "cannot open restore file",
+                            "restore_file", "restore_data_file",
+                            "failed", td, NULL, filename, 0, 0, errno);
+    g_critical("cannot open file %s at %"G_GUINT64_FORMAT" (%d)", filename, offset, errno);
+    errors++;
+    if (infile)
+      fclose(infile);
+    return 1;
+  }
+  int r=restore_data_from_mydumper_infile(td, filename, infile, FALSE, use_database, offset + length);
+  fclose(infile);
+  return r;
+}
+
 // return 0 means everything was ok
 int restore_data_in_gstring_extended(struct thread_data *td, GString *data, gboolean is_schema, struct database *use_database, void log_fun(const char *, ...) , const char *fmt, ...){
   va_list    args;
@@ -1043,18 +1597,18 @@ int restore_data_in_gstring_extended(struct thread_data *td, GString *data, gboo
           if(ir->error)
             g_free(ir->error);
           ir->error=NULL;
-          g_async_queue_push(queue->restore,ir);
+          statement_ring_push(queue->restore, ir);
           r+=process_result_vstatement(queue->result, &ir, log_fun, fmt, args);
        }
     }
     g_strfreev(line);
   }
   g_async_queue_push(free_results_queue,ir);
-  g_async_queue_push(queue->restore,&release_connection_statement);
+  statement_ring_push(queue->restore, &release_connection_statement);
   td->granted_connections--;
   r+=process_result_vstatement(queue->result, &ir, log_fun, fmt, args);
-  g_assert(g_async_queue_length(queue->restore)<=0);
-  g_assert(g_async_queue_length(queue->result)<=0);
+  g_assert(statement_ring_length(queue->restore)<=0);
+  g_assert(statement_ring_length(queue->result)<=0);
   g_async_queue_push(restore_queues, queue);
   va_end(args);
   return r;
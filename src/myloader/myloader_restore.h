@@ -39,6 +39,7 @@ void start_connection_pool();
 int restore_data_in_gstring(struct thread_data *td, GString *data, gboolean is_schema, struct database *use_database);
 int restore_data_in_gstring_extended(struct thread_data *td, GString *data, gboolean is_schema, struct database *use_database, void log_fun(const char *, ...) , const char *fmt, ...);
 int restore_data_from_mydumper_file(struct thread_data *td, const char *filename, gboolean is_schema, struct database *use_database);
+int restore_data_from_segment(struct thread_data *td, const char *filename, guint64 offset, guint64 length, struct database *use_database);
 void release_load_data_as_it_is_close( gchar * filename );
 void close_restore_thread();
 void wait_restore_threads_to_close();
@@ -22,6 +22,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <glib-unix.h>
+#include <gio/gio.h>
+#include <unistd.h>
 
 #include "myloader.h"
 #include "myloader_restore_job.h"
@@ -33,6 +35,7 @@
 #include "myloader_worker_loader.h"
 #include "myloader_worker_index.h"
 #include "myloader_database.h"
+#include "myloader_process.h"
 
 unsigned long long int total_data_sql_files = 0;
 gboolean shutdown_triggered=FALSE;
@@ -55,6 +58,7 @@ struct data_restore_job * new_data_restore_job_internal( guint index, guint part
   drj->index    = index;
   drj->part     = part;
   drj->sub_part = sub_part;
+  drj->segment  = NULL;
   return drj;
 }
 
@@ -118,6 +122,78 @@ void overwrite_table_message(const char *fmt, ...){
 
 }
 
+static
+gboolean copy_tablespace_file(const gchar *source, const gchar *destination, GStatBuf *owner){
+  GFile *s=g_file_new_for_path(source), *d=g_file_new_for_path(destination);
+  GError *error=NULL;
+  gboolean r=g_file_copy(s, d, G_FILE_COPY_OVERWRITE, NULL, NULL, NULL, &error);
+  g_object_unref(s);
+  g_object_unref(d);
+  if (!r){
+    g_critical("Not able to copy %s to %s: %s", source, destination, error->message);
+    g_error_free(error);
+    return FALSE;
+  }
+  // The server must be able to read and write the file
+  g_chmod(destination, 0640);
+  if (geteuid() == 0 && chown(destination, owner->st_uid, owner->st_gid))
+    g_warning("Not able to change the owner of %s", destination);
+  return TRUE;
+}
+
+// The rows of the table are in the .ibd and .cfg files copied by mydumper,
+// which are placed on the datadir of the server after discarding the
+// tablespace that was created with the table
+static
+int import_tablespace(struct thread_data *td, struct db_table *dbt){
+  const char q= identifier_quote_character;
+  GString *data=g_string_new("");
+  GStatBuf owner;
+  gchar *database_directory=g_build_filename(datadir?datadir:"", dbt->database->target_database, NULL);
+  gchar *filename=NULL, *source=NULL, *destination=NULL;
+  const gchar *extensions[]={"ibd", "cfg", NULL};
+  guint i=0;
+  int r=0;
+  if (datadir == NULL || g_stat(database_directory, &owner)){
+    g_critical("Datadir %s is not accessible, not able to import the tablespace of %s.%s. Use --datadir if myloader runs on the database host", database_directory, dbt->database->target_database, dbt->source_table_name);
+    g_free(database_directory);
+    g_string_free(data, TRUE);
+    return 1;
+  }
+  message("Thread %d: Importing tablespace of %s.%s", td->thread_id, dbt->database->target_database, dbt->source_table_name);
+  g_string_printf(data,"ALTER TABLE %c%s%c.%c%s%c DISCARD TABLESPACE",
+      q, dbt->database->target_database, q, q, dbt->source_table_name, q);
+  r=restore_data_in_gstring(td, data, TRUE, dbt->database);
+  for (i=0; !r && extensions[i]; i++){
+    filename=g_strdup_printf("%s.%s.%s", dbt->database->database_name_in_filename, dbt->table_filename, extensions[i]);
+    source=g_build_filename(directory, filename, NULL);
+    g_free(filename);
+    filename=g_strdup_printf("%s.%s", dbt->source_table_name, extensions[i]);
+    destination=g_build_filename(database_directory, filename, NULL);
+    if (!copy_tablespace_file(source, destination, &owner))
+      r=1;
+    g_free(filename);
+    g_free(source);
+    g_free(destination);
+  }
+  if (!r){
+    g_string_printf(data,"ALTER TABLE %c%s%c.%c%s%c IMPORT TABLESPACE",
+        q, dbt->database->target_database, q, q, dbt->source_table_name, q);
+    r=restore_data_in_gstring(td, data, TRUE, dbt->database);
+  }
+  // The server doesn't need the .cfg after the import
+  filename=g_strdup_printf("%s.cfg", dbt->source_table_name);
+  destination=g_build_filename(database_directory, filename, NULL);
+  g_remove(destination);
+  g_free(filename);
+  g_free(destination);
+  g_free(database_directory);
+  g_string_free(data, TRUE);
+  if (r)
+    g_critical("Thread %d: issue importing the tablespace of %s.%s", td->thread_id, dbt->database->target_database, dbt->source_table_name);
+  return r;
+}
+
 static
 int overwrite_table(struct thread_data *td, struct db_table *dbt){
   int truncate_or_delete_failed=0;
@@ -437,6 +513,8 @@ int process_restore_job(struct thread_data *td, struct restore_job *rj){
         }
         if (max_threads_for_schema_creation==1) g_mutex_unlock(single_threaded_create_table);
       }
+      if (dbt->transportable_tablespace && !no_data && !dbt->object_to_import.no_data && import_tablespace(td, dbt))
+        g_atomic_int_inc(&(detailed_errors.schema_errors));
       /* Signal waiting data workers that schema is ready */
       table_lock(dbt);
       dbt->schema_state=CREATED;
@@ -486,7 +564,9 @@ int process_restore_job(struct thread_data *td, struct restore_job *rj){
                       dbt->database->target_database, dbt->source_table_name, rj->data.drj->index, dbt->count, rj->filename, progress,total_data_sql_files, total , g_hash_table_size(td->conf->table_hash));
           }
           g_mutex_unlock(progress_mutex);
-          if (restore_data_from_file(td, rj->filename, FALSE, dbt->database) > 0){
+          if ((rj->data.drj->segment ?
+                restore_data_from_segment(td, rj->filename, rj->data.drj->segment->offset, rj->data.drj->segment->length, dbt->database) :
+                restore_data_from_file(td, rj->filename, FALSE, dbt->database)) > 0){
             g_atomic_int_inc(&(detailed_errors.data_errors));
             if (machine_log_json) {
               gchar *thread_id = g_strdup_printf("%u", td->thread_id);
@@ -511,6 +591,8 @@ int process_restore_job(struct thread_data *td, struct restore_job *rj){
           }
       }
       g_atomic_int_dec_and_test(&(dbt->remaining_jobs));
+      if (rj->data.drj->segment)
+        release_bundle_segment(rj->data.drj->segment);
       g_free(rj->data.drj);
       break;
     case JOB_RESTORE_SCHEMA_FILENAME:
@@ -66,10 +66,30 @@ const char * rjstmtype2str(enum restore_job_statement_type rjstmtype)
   return 0;
 }
 
+// Byte range of a file shared by several restore jobs: the data of a table
+// inside a --coalesce-tables bundle, or a frame of a file with a zstd seek
+// table. The file is released when the last segment is done.
+struct bundle{
+  gchar *filename;
+  gint remaining;
+};
+
+struct bundle_segment{
+  struct bundle *bundle;
+  guint64 offset;
+  guint64 length;
+};
+
+struct zstd_frame{
+  guint32 compressed_size;
+  guint32 decompressed_size;
+};
+
 struct data_restore_job{
   guint index;
   guint part;
   guint sub_part;
+  struct bundle_segment *segment;
 };
 
 struct schema_restore_job{
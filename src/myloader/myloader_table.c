@@ -155,6 +155,10 @@ gboolean append_new_db_table( struct db_table **p_dbt, struct database *_databas
 
       dbt->is_view=FALSE;
       dbt->is_sequence=FALSE;
+      dbt->transportable_tablespace=FALSE;
+      dbt->has_triggers=FALSE;
+      dbt->is_transactional=FALSE;
+      dbt->load_data_checked=FALSE;
       dbt->in_ready_queue=FALSE;
     }else{
       if (is_view){
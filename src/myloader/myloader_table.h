@@ -51,6 +51,10 @@ struct db_table {
   struct table_level_checksum checksum;
   gboolean is_view;
   gboolean is_sequence;
+  gboolean transportable_tablespace;
+  gboolean has_triggers;
+  gboolean is_transactional;
+  gboolean load_data_checked;
   // O(1) ready queue flag: prevents duplicate enqueuing
   gboolean in_ready_queue;
 };
@@ -20,6 +20,8 @@
 #include "myloader_common.h"
 #include "myloader_global.h"
 #include "myloader_restore_job.h"
+#include "myloader_control_job.h"
+#include "../common_options.h"
 #include "../logging.h"
 
 GThread **post_threads = NULL;
@@ -32,6 +34,185 @@ guint sync_threads_remaining;
 guint sync_threads_remaining1;
 guint sync_threads_remaining2;
 
+/* Views are restored following their dependencies: a view is enqueued on
+   view_queue once every view that it references has been created. */
+struct view_node {
+  struct control_job *job;
+  gchar *database;
+  GString *statement;
+  GList *dependents;
+  guint pending;
+  gboolean visited;
+};
+
+static GMutex *view_graph_mutex=NULL;
+static GHashTable *view_graph=NULL;
+static GHashTable *view_graph_by_job=NULL;
+static guint views_remaining=0;
+static gboolean views_scheduled=FALSE;
+
+void initialize_view_graph(){
+  view_graph_mutex=g_mutex_new();
+  view_graph=g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  view_graph_by_job=g_hash_table_new(g_direct_hash, g_direct_equal);
+}
+
+void add_view_to_graph(struct control_job *job, gchar *database, gchar *view, GString *statement){
+  struct view_node *node=g_new0(struct view_node, 1);
+  node->job=job;
+  node->database=database;
+  node->statement=statement;
+  gchar *key=g_strdup_printf("%s.%s", database, view);
+  g_mutex_lock(view_graph_mutex);
+  if (g_hash_table_contains(view_graph, key))
+    g_free(key);
+  else
+    g_hash_table_insert(view_graph, key, node);
+  g_hash_table_insert(view_graph_by_job, job, node);
+  views_remaining++;
+  g_mutex_unlock(view_graph_mutex);
+}
+
+static
+gchar *read_quoted_identifier(const gchar **p){
+  GString *identifier=g_string_new(NULL);
+  const gchar *c=*p+1;
+  while (*c != '\0'){
+    if (*c == identifier_quote_character){
+      if (*(c+1) != identifier_quote_character){
+        c++;
+        break;
+      }
+      c++;
+    }
+    g_string_append_c(identifier, *c);
+    c++;
+  }
+  *p=c;
+  return g_string_free(identifier, FALSE);
+}
+
+static
+void add_view_dependency(struct view_node *node, gchar *key){
+  struct view_node *dependency=g_hash_table_lookup(view_graph, key);
+  if (dependency == NULL || dependency == node || g_list_find(dependency->dependents, node))
+    return;
+  trace("View %s depends on %s", node->job->data.restore_job->filename, key);
+  dependency->dependents=g_list_prepend(dependency->dependents, node);
+  node->pending++;
+}
+
+// Every quoted identifier, or `database`.`object` pair, in the statement that
+// matches a view being restored is taken as a dependency
+static
+void add_view_dependencies(struct view_node *node){
+  if (node->statement == NULL)
+    return;
+  const gchar *p=node->statement->str;
+  gchar *first, *second, *key;
+  while (*p != '\0'){
+    if (*p == '\''){
+      for (p++; *p != '\0' && *p != '\''; p++)
+        if (*p == '\\' && *(p+1) != '\0')
+          p++;
+      if (*p != '\0')
+        p++;
+      continue;
+    }
+    if (*p != identifier_quote_character){
+      p++;
+      continue;
+    }
+    first=read_quoted_identifier(&p);
+    if (*p == '.' && *(p+1) == identifier_quote_character){
+      p++;
+      second=read_quoted_identifier(&p);
+      key=g_strdup_printf("%s.%s", first, second);
+      g_free(second);
+    }else
+      key=g_strdup_printf("%s.%s", node->database, first);
+    add_view_dependency(node, key);
+    g_free(key);
+    g_free(first);
+    while (*p == '.' && *(p+1) == identifier_quote_character){
+      p++;
+      g_free(read_quoted_identifier(&p));
+    }
+  }
+}
+
+static
+void push_view_shutdown_jobs(struct configuration *conf){
+  guint n=0;
+  for (n = 0; n < max_threads_for_post_creation; n++)
+    g_async_queue_push(conf->view_queue, new_control_job(JOB_SHUTDOWN,NULL,NULL));
+}
+
+// Must be called holding view_graph_mutex
+static
+void schedule_views(struct configuration *conf){
+  GHashTableIter iter;
+  struct view_node *node=NULL;
+  GList *nodes=g_hash_table_get_values(view_graph_by_job), *l, *d;
+  GQueue *ready=g_queue_new();
+  GHashTable *remaining=g_hash_table_new(g_direct_hash, g_direct_equal);
+
+  for (l=nodes; l; l=l->next)
+    add_view_dependencies(l->data);
+
+  // Nodes that cannot be reached from a view without dependencies are part
+  // of a cycle, or depend on one. They are released at once and will rely on
+  // the placeholder tables, as before.
+  for (l=nodes; l; l=l->next){
+    node=l->data;
+    g_hash_table_insert(remaining, node, GUINT_TO_POINTER(node->pending));
+    if (node->pending == 0)
+      g_queue_push_tail(ready, node);
+  }
+  while ((node=g_queue_pop_head(ready)) != NULL){
+    node->visited=TRUE;
+    for (d=node->dependents; d; d=d->next){
+      guint count=GPOINTER_TO_UINT(g_hash_table_lookup(remaining, d->data)) - 1;
+      g_hash_table_insert(remaining, d->data, GUINT_TO_POINTER(count));
+      if (count == 0)
+        g_queue_push_tail(ready, d->data);
+    }
+  }
+  for (l=nodes; l; l=l->next){
+    node=l->data;
+    if (!node->visited){
+      g_warning("Circular dependency found on view %s", node->job->data.restore_job->filename);
+      node->pending=0;
+    }
+  }
+  g_hash_table_destroy(remaining);
+  g_queue_free(ready);
+
+  g_hash_table_iter_init(&iter, view_graph_by_job);
+  while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&node))
+    if (node->pending == 0)
+      g_async_queue_push(conf->view_queue, node->job);
+  g_list_free(nodes);
+
+  if (views_remaining == 0)
+    push_view_shutdown_jobs(conf);
+}
+
+static
+void view_restored(struct configuration *conf, struct view_node *node){
+  GList *d;
+  g_mutex_lock(view_graph_mutex);
+  for (d=node->dependents; d; d=d->next){
+    struct view_node *dependent=d->data;
+    if (dependent->pending > 0 && --dependent->pending == 0)
+      g_async_queue_push(conf->view_queue, dependent->job);
+  }
+  views_remaining--;
+  if (views_remaining == 0)
+    push_view_shutdown_jobs(conf);
+  g_mutex_unlock(view_graph_mutex);
+}
+
 void initialize_post_loding_threads(struct configuration *conf){
   guint n=0;
 //  post_mutex = g_mutex_new();
@@ -97,10 +278,26 @@ void *worker_post_thread(struct thread_data *td) {
     cont=process_job(td, job, NULL);
   }
   sync_threads(&sync_threads_remaining2,sync_mutex2);
+  g_mutex_lock(view_graph_mutex);
+  if (!views_scheduled){
+    views_scheduled=TRUE;
+    schedule_views(conf);
+  }
+  g_mutex_unlock(view_graph_mutex);
   cont=TRUE;
+  struct view_node *node=NULL;
   while (cont){
     job = (struct control_job *)g_async_queue_pop(conf->view_queue);
+    // The entry is removed before process_job() frees the job, as a new job,
+    // like the shutdown ones, might get the same address
+    g_mutex_lock(view_graph_mutex);
+    node=g_hash_table_lookup(view_graph_by_job, job);
+    if (node)
+      g_hash_table_remove(view_graph_by_job, job);
+    g_mutex_unlock(view_graph_mutex);
     cont=process_job(td, job, NULL);
+    if (node)
+      view_restored(conf, node);
   }
 
   trace("Thread %u: ending", td->thread_id);
@@ -112,7 +309,6 @@ void create_post_shutdown_job(struct configuration *conf){
   for (n = 0; n < max_threads_for_post_creation; n++) {
     g_async_queue_push(conf->post_queue, new_control_job(JOB_SHUTDOWN,NULL,NULL));
     g_async_queue_push(conf->post_table_queue, new_control_job(JOB_SHUTDOWN,NULL,NULL));
-    g_async_queue_push(conf->view_queue, new_control_job(JOB_SHUTDOWN,NULL,NULL));
   }
 }
 
@@ -15,7 +15,10 @@
         Authors:    David Ducos, Percona (david dot ducos at percona dot com)
 */
 #include "myloader.h"
+#include "myloader_control_job.h"
 
+void initialize_view_graph();
+void add_view_to_graph(struct control_job *job, gchar *database, gchar *view, GString *statement);
 void initialize_post_loding_threads(struct configuration *conf);
 void create_post_shutdown_job(struct configuration *conf);
 void wait_post_worker_to_finish();
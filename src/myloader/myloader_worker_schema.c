@@ -29,17 +29,14 @@
 static
 GAsyncQueue *refresh_db_queue2 = NULL;
 extern GHashTable *database_hash;
+/* schema_job_queue has a token per job and the jobs are kept on a queue per
+   type, so threads always take the lowest type available without sorting */
 GAsyncQueue *schema_job_queue = NULL;
+static
+GAsyncQueue *schema_job_queue_by_type[SCHEMA_ENDED + 1];
 struct thread_data *schema_td = NULL;
 GAsyncQueue *retry_queue = NULL;
 
-gint schema_job_cmp(gconstpointer _a, gconstpointer _b, gpointer user_data){
-   struct schema_job *a= ((struct schema_job *) _a);
-   struct schema_job *b= ((struct schema_job *) _b);
-   (void)user_data;
-   return (a->type > b->type) - (a->type < b->type);
-}
-
 struct schema_job * new_schema_job(enum schema_job_type type, struct restore_job *rj, struct database *use_database){
   struct schema_job * sj = g_new0(struct schema_job, 1);
   sj->type = type;
@@ -52,7 +49,19 @@ struct schema_job * new_schema_job(enum schema_job_type type, struct restore_job
 static
 void schema_job_queue_push(struct schema_job *sj){
   trace("schema_job_queue <- %s", schema_job_type2str(sj->type));
-  g_async_queue_push(schema_job_queue, sj);
+  g_async_queue_push(schema_job_queue_by_type[sj->type], sj);
+  g_async_queue_push(schema_job_queue, GINT_TO_POINTER(1));
+}
+
+static
+struct schema_job *schema_job_queue_pop(){
+  struct schema_job *sj = NULL;
+  guint type;
+  g_async_queue_pop(schema_job_queue);
+  for (type = SCHEMA_CREATE_JOB; sj == NULL && type <= SCHEMA_ENDED; type++)
+    sj = g_async_queue_try_pop(schema_job_queue_by_type[type]);
+  g_assert(sj);
+  return sj;
 }
 
 gboolean schema_push( enum schema_job_type schema_worker_job, gchar * filename, enum restore_job_type rj_type, struct db_table * dbt, struct database * _database, GString * statement, enum restore_job_statement_type object, struct database *use_database ){
@@ -79,8 +88,7 @@ gboolean schema_push( enum schema_job_type schema_worker_job, gchar * filename,
     
     }
   }else{
-    trace("schema_job_queue <- %s (sorted)", schema_job_type2str(sj->type));
-    g_async_queue_push_sorted(schema_job_queue, sj, &schema_job_cmp, NULL);
+    schema_job_queue_push(sj);
   }
   g_mutex_unlock(_database->mutex);
   return TRUE;
@@ -154,7 +162,7 @@ gboolean second_round=FALSE;
 gboolean process_schema(struct thread_data * td){
   struct database * _database = NULL;
 
-  struct schema_job * schema_job = g_async_queue_pop(schema_job_queue);
+  struct schema_job * schema_job = schema_job_queue_pop();
   trace("schema_job_queue -> %s", schema_job_type2str(schema_job->type));
 
   switch (schema_job->type){
@@ -202,7 +210,7 @@ gboolean process_schema(struct thread_data * td){
       break;
 
     case SCHEMA_ENDED:
-      g_async_queue_push(schema_job_queue, schema_job);
+      schema_job_queue_push(schema_job);
       //refresh_table_list(td->conf);
       return FALSE;
       break;
@@ -234,6 +242,9 @@ void initialize_worker_schema(struct configuration *conf){
   guint n=0;
   refresh_db_queue2 = g_async_queue_new();
   schema_job_queue = g_async_queue_new();
+  for (n = SCHEMA_CREATE_JOB; n <= SCHEMA_ENDED; n++)
+    schema_job_queue_by_type[n] = g_async_queue_new();
+  n=0;
   retry_queue = g_async_queue_new();
   schema_threads = g_new(GThread *, max_threads_for_schema_creation);
   schema_td = g_new(struct thread_data, max_threads_for_schema_creation);
@@ -25,6 +25,9 @@
 const char * filename_regex="^[\\w\\-_ ]+$";
 
 GList *re_list = NULL;
+/* All the --regex patterns as a single alternation, when they can be
+   combined, so filtering a name is a single match */
+static pcre2_code *combined_re = NULL;
 static pcre2_code *filename_re = NULL;
 static pcre2_code *partition_re = NULL;
 GList *regex_list=NULL;
@@ -53,12 +56,46 @@ GOptionGroup * load_regex_entries(GOptionContext *context){
   return filter_group;
 }
 
+/* Filters only need to know if there is a match, so every thread uses a
+   match data of a single pair, and a buffer to build 'db.table'. Both are
+   allocated once per thread.
+   With a single pair pcre2_match returns 0 when the pattern has capture
+   groups, which is still a match. */
+struct regex_thread_data {
+  pcre2_match_data *match_data;
+  GString *name;
+};
+
+static
+void free_regex_thread_data(gpointer data){
+  struct regex_thread_data *rtd=data;
+  pcre2_match_data_free(rtd->match_data);
+  g_string_free(rtd->name, TRUE);
+  g_free(rtd);
+}
+
+static GPrivate regex_thread_data_key = G_PRIVATE_INIT(free_regex_thread_data);
+
+static
+struct regex_thread_data *get_regex_thread_data(){
+  struct regex_thread_data *rtd=g_private_get(&regex_thread_data_key);
+  if (rtd == NULL){
+    rtd=g_new(struct regex_thread_data, 1);
+    rtd->match_data=pcre2_match_data_create(1, NULL);
+    rtd->name=g_string_sized_new(128);
+    g_private_set(&regex_thread_data_key, rtd);
+  }
+  return rtd;
+}
+
+static
+gboolean match_regex(pcre2_code *re, const char *word, gsize len){
+  return pcre2_match(re, (PCRE2_SPTR)word, len, 0, 0, get_regex_thread_data()->match_data, NULL) >= 0;
+}
+
 gboolean check_filename_regex(char *word) {
-  /* This is not going to be used in threads */
   if (filename_re){
-    pcre2_match_data *match_data = pcre2_match_data_create_from_pattern(filename_re, NULL);
-    int rc =pcre2_match(filename_re, (PCRE2_SPTR)word, strlen(word), 0, 0, match_data, NULL);
-    return (rc > 0) ? TRUE : FALSE;
+    return match_regex(filename_re, word, strlen(word));
   }
   return TRUE;
 }
@@ -77,41 +114,72 @@ void init_regex(pcre2_code **r, const char *str){
   }
 }
 
+/* Patterns with back references can not be combined, as the group numbers
+   change inside the alternation. Any other problem, like a pattern that
+   starts with an option setting, makes the compilation fail and the patterns
+   are evaluated one by one. */
+static
+void init_combined_regex(){
+  GList *l=NULL;
+  guint32 backref_max=0;
+  int error;
+  PCRE2_SIZE erroroffset;
+  if (g_list_length(re_list) < 2)
+    return;
+  GString *combined=g_string_sized_new(256);
+  for (l=re_list; l; l=l->next){
+    pcre2_pattern_info(l->data, PCRE2_INFO_BACKREFMAX, &backref_max);
+    if (backref_max > 0){
+      g_string_free(combined, TRUE);
+      return;
+    }
+  }
+  for (l=regex_list; l; l=l->next)
+    g_string_append_printf(combined, "%s(?:%s)", l==regex_list?"":"|", (gchar *)l->data);
+  combined_re = pcre2_compile((PCRE2_SPTR)combined->str, combined->len, PCRE2_CASELESS | PCRE2_MULTILINE, &error,
+                              &erroroffset, NULL);
+  if (combined_re)
+    pcre2_jit_compile(combined_re, PCRE2_JIT_COMPLETE);
+  g_string_free(combined, TRUE);
+}
+
 void initialize_regex(gchar * partition_regex){
   init_regex(&filename_re,filename_regex);
+  pcre2_jit_compile(filename_re, PCRE2_JIT_COMPLETE);
   GList *l=NULL;
   pcre2_code *_re=NULL;
   l=regex_list;
   while (l){
     init_regex(&_re,l->data);
+    pcre2_jit_compile(_re, PCRE2_JIT_COMPLETE);
     re_list=g_list_append(re_list,_re);
     _re=NULL;
     l=l->next;
   }
-  if (partition_regex)
+  init_combined_regex();
+  if (partition_regex){
     init_regex(&partition_re, partition_regex);
+    pcre2_jit_compile(partition_re, PCRE2_JIT_COMPLETE);
+  }
 }
 
 /* Check database.table string against regular expression */
 gboolean check_regex(pcre2_code *tre, char *_database_name, char * _table_name) {
-  /* This is not going to be used in threads */
   if (tre){
     g_assert(_database_name);
-    char * p = NULL;
-    if (_table_name)
-      p = g_strdup_printf("%s.%s", _database_name, _table_name);
-    else
-      p = g_strdup_printf("%s", _database_name);
-    pcre2_match_data *match_data = pcre2_match_data_create_from_pattern(tre, NULL);
-    int rc = pcre2_match(tre, (PCRE2_SPTR)p, strlen(p), 0, 0, match_data, NULL);
-  
-    g_free(p);
-
-    return (rc > 0) ? TRUE : FALSE;
+    if (!_table_name)
+      return match_regex(tre, _database_name, strlen(_database_name));
+    GString *name=get_regex_thread_data()->name;
+    g_string_assign(name, _database_name);
+    g_string_append_c(name, '.');
+    g_string_append(name, _table_name);
+    return match_regex(tre, name->str, name->len);
   } return FALSE;
 }
 
 gboolean eval_regex(char * _database_name,char * _table_name){
+  if (combined_re)
+    return check_regex(combined_re, _database_name, _table_name);
   if (re_list){
     GList *l=re_list;
     gboolean r=FALSE;
@@ -126,9 +194,7 @@ gboolean eval_regex(char * _database_name,char * _table_name){
 
 gboolean eval_pcre_regex(pcre2_code * re, char * word){
   if (re){
-    pcre2_match_data *match_data = pcre2_match_data_create_from_pattern(re, NULL);
-    int rc = pcre2_match(re, (PCRE2_SPTR)word, strlen(word), 0, 0, match_data, NULL);
-    return (rc > 0) ? TRUE : FALSE;
+    return match_regex(re, word, strlen(word));
   }
   return TRUE;
 }
@@ -75,6 +75,31 @@ gboolean server_support_tablespaces(){
   return get_product() == SERVER_TYPE_PERCONA || get_product() == SERVER_TYPE_MYSQL || get_product() == SERVER_TYPE_UNKNOWN || get_product() == SERVER_TYPE_RDS;
 }
 
+gboolean server_support_window_functions(){
+  switch (get_product()){
+    case SERVER_TYPE_MARIADB:
+      return get_major() > 10 || (get_major() == 10 && get_secondary() >= 2);
+    case SERVER_TYPE_TIDB:
+      return TRUE;
+    case SERVER_TYPE_CLICKHOUSE:
+      return FALSE;
+    default:
+      return get_major() >= 8;
+  }
+}
+
+gboolean server_support_column_statistics(){
+  switch (get_product()){
+    case SERVER_TYPE_MYSQL:
+    case SERVER_TYPE_PERCONA:
+    case SERVER_TYPE_RDS:
+    case SERVER_TYPE_GOOGLE:
+      return get_major() >= 8;
+    default:
+      return FALSE;
+  }
+}
+
 static
 void detect_product(gchar *_ascii_version_comment, gchar *_ascii_version){
   gchar *ascii_version=_ascii_version?g_ascii_strdown(_ascii_version,-1):NULL;
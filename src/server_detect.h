@@ -32,6 +32,8 @@ enum server_type {
 };
 void server_detect(MYSQL * conn);
 gboolean server_support_tablespaces();
+gboolean server_support_window_functions();
+gboolean server_support_column_statistics();
 int get_product();
 int get_major();
 int get_secondary();
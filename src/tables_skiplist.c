@@ -15,18 +15,31 @@
 #include <glib.h>
 #include <string.h>
 
-GSequence *tables_skiplist = NULL;
-GMutex *tables_skiplist_mutex = NULL;
+/* The skip list is built once, before any thread is started, and it is only
+ * read afterwards, so lookups need no lock.
+ * tables_skiplist has every line of the file. tables_skiplist_per_database
+ * maps a database to the set of its tables to skip; a line is added once per
+ * '.' that it has, so "a.b.c" is found as `a`.`b.c` and as `a.b`.`c`, just
+ * like comparing it against the "database.table" string. */
+GHashTable *tables_skiplist = NULL;
+GHashTable *tables_skiplist_per_database = NULL;
 
-/* Comparison function for skiplist sort and lookup */
-
-int tables_skiplist_cmp(gconstpointer a, gconstpointer b, gpointer user_data) {
-  /* Not using user_data, but needed for function prototype, shutting up
-   * compiler warnings about unused variable */
-  (void)user_data;
-  /* Any sorting function would work, as long as its usage is consistent
-   * between sort and lookup.  strcmp should be one of the fastest. */
-  return strcmp(a, b);
+static
+void add_to_tables_skiplist(gchar *line) {
+  gchar *dot = line;
+  GHashTable *tables = NULL;
+  g_hash_table_add(tables_skiplist, line);
+  while ((dot = strchr(dot, '.')) != NULL) {
+    gchar *database = g_strndup(line, dot - line);
+    tables = g_hash_table_lookup(tables_skiplist_per_database, database);
+    if (!tables) {
+      tables = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+      g_hash_table_insert(tables_skiplist_per_database, database, tables);
+    } else
+      g_free(database);
+    dot++;
+    g_hash_table_add(tables, g_strdup(dot));
+  }
 }
 
 /* Read the list of tables to skip from the given filename, and prepares them
@@ -39,8 +52,8 @@ void read_tables_skiplist(const gchar *filename, guint *errors) {
   GError *error = NULL;
   /* Create skiplist if it does not exist */
   if (!tables_skiplist) {
-    tables_skiplist = g_sequence_new(NULL);
-    tables_skiplist_mutex = g_mutex_new();
+    tables_skiplist = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    tables_skiplist_per_database = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_hash_table_destroy);
   };
   tables_skiplist_channel = g_io_channel_new_file(filename, "r", &error);
 
@@ -51,38 +64,27 @@ void read_tables_skiplist(const gchar *filename, guint *errors) {
     return;
   };
 
-  /* Read lines, push them to the list */
+  /* Read lines, push them to the index */
   do {
     g_io_channel_read_line(tables_skiplist_channel, &buf, NULL, NULL, NULL);
     if (buf) {
       g_strchomp(buf);
-      g_sequence_append(tables_skiplist, buf);
+      add_to_tables_skiplist(buf);
     };
   } while (buf);
   g_io_channel_shutdown(tables_skiplist_channel, FALSE, NULL);
-  /* Sort the list, so that lookups work */
-  g_sequence_sort(tables_skiplist, tables_skiplist_cmp, NULL);
   g_message("Omit list file contains %d tables to skip\n",
-            g_sequence_get_length(tables_skiplist));
+            g_hash_table_size(tables_skiplist));
   return;
 }
 
 /* Check database.table string against skip list; returns TRUE if found */
 
 gboolean check_skiplist(char *database, char *table) {
-  g_mutex_lock(tables_skiplist_mutex);
-  gboolean b = g_sequence_lookup(tables_skiplist,
-                        database,
-                        tables_skiplist_cmp, NULL) != NULL;
-  if (!table || b){
-    g_mutex_unlock(tables_skiplist_mutex);
-    return b;
-  }
-  gchar * k=g_strdup_printf("%s.%s", database, table);
-  b = g_sequence_lookup(tables_skiplist,
-                        k,
-                        tables_skiplist_cmp, NULL) != NULL;
-  g_mutex_unlock(tables_skiplist_mutex);
-  g_free(k);
-  return b;
+  if (g_hash_table_contains(tables_skiplist, database))
+    return TRUE;
+  if (!table)
+    return FALSE;
+  GHashTable *tables = g_hash_table_lookup(tables_skiplist_per_database, database);
+  return tables != NULL && g_hash_table_contains(tables, table);
 }
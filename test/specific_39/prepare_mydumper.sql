@@ -0,0 +1,24 @@
+
+DROP DATABASE IF EXISTS specific_39;
+CREATE DATABASE specific_39;
+
+USE specific_39;
+
+CREATE TABLE digits (d int NOT NULL PRIMARY KEY);
+INSERT INTO digits VALUES (0),(1),(2),(3),(4),(5),(6),(7),(8),(9);
+
+CREATE TABLE table_uuid_pk (
+  `id` char(32) NOT NULL,
+  `val` int(11) DEFAULT NULL,
+  PRIMARY KEY (`id`)
+) ENGINE=InnoDB;
+
+INSERT INTO table_uuid_pk SELECT MD5(n), n FROM (SELECT a.d + b.d*10 + c.d*100 + e.d*1000 AS n FROM digits a, digits b, digits c, digits e) x;
+
+CREATE TABLE table_varchar_pk (
+  `id` varchar(20) NOT NULL,
+  `val` int(11) DEFAULT NULL,
+  PRIMARY KEY (`id`)
+) ENGINE=InnoDB;
+
+INSERT INTO table_varchar_pk SELECT CONCAT(CHAR(65 + n % 3), '''', n), n FROM (SELECT a.d + b.d*10 + c.d*100 + e.d*1000 AS n FROM digits a, digits b, digits c, digits e) x;
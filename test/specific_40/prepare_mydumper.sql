@@ -0,0 +1,26 @@
+
+DROP DATABASE IF EXISTS specific_40;
+CREATE DATABASE specific_40;
+
+USE specific_40;
+
+CREATE TABLE digits (d int NOT NULL PRIMARY KEY);
+INSERT INTO digits VALUES (0),(1),(2),(3),(4),(5),(6),(7),(8),(9);
+
+CREATE TABLE table_non_unique_index (
+  `val` int(11) DEFAULT NULL,
+  `txt` varchar(32) DEFAULT NULL,
+  KEY `val` (`val`)
+) ENGINE=InnoDB;
+
+INSERT INTO table_non_unique_index SELECT n DIV 2, MD5(n) FROM (SELECT a.d + b.d*10 + c.d*100 + e.d*1000 AS n FROM digits a, digits b, digits c, digits e) x;
+INSERT INTO table_non_unique_index VALUES (NULL, 'null value');
+
+CREATE TABLE table_string_pk_integer_unique (
+  `id` varchar(32) NOT NULL,
+  `val` int(11) NOT NULL,
+  PRIMARY KEY (`id`),
+  UNIQUE KEY `val` (`val`)
+) ENGINE=InnoDB;
+
+INSERT INTO table_string_pk_integer_unique SELECT MD5(n), n FROM (SELECT a.d + b.d*10 + c.d*100 + e.d*1000 AS n FROM digits a, digits b, digits c, digits e) x;
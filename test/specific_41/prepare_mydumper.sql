@@ -0,0 +1,26 @@
+DROP DATABASE IF EXISTS specific_41;
+CREATE DATABASE specific_41;
+
+USE specific_41;
+
+CREATE TABLE digits (d int NOT NULL PRIMARY KEY);
+INSERT INTO digits VALUES (0),(1),(2),(3),(4),(5),(6),(7),(8),(9);
+
+CREATE TABLE table_three_integer_columns (
+  `tenant_id` int(11) NOT NULL,
+  `created_at` int(11) NOT NULL,
+  `id` int(11) NOT NULL,
+  `txt` varchar(32) DEFAULT NULL,
+  PRIMARY KEY (`tenant_id`,`created_at`,`id`)
+) ENGINE=InnoDB;
+
+INSERT INTO table_three_integer_columns SELECT n % 3, n DIV 1000, n, MD5(n) FROM (SELECT a.d + b.d*10 + c.d*100 + e.d*1000 AS n FROM digits a, digits b, digits c, digits e) x;
+
+CREATE TABLE table_integer_string_columns (
+  `tenant_id` int(11) NOT NULL,
+  `code` varchar(32) NOT NULL,
+  `txt` varchar(32) DEFAULT NULL,
+  PRIMARY KEY (`tenant_id`,`code`)
+) ENGINE=InnoDB;
+
+INSERT INTO table_integer_string_columns SELECT n % 2, MD5(n), CONCAT('it''s ', n) FROM (SELECT a.d + b.d*10 + c.d*100 + e.d*1000 AS n FROM digits a, digits b, digits c, digits e) x;
@@ -0,0 +1,12 @@
+DROP DATABASE IF EXISTS specific_42;
+CREATE DATABASE specific_42;
+
+USE specific_42;
+
+CREATE TABLE t (id int primary key, val varchar(10));
+INSERT INTO t VALUES (1,'a'),(2,'b'),(3,'c');
+
+CREATE VIEW v1 AS SELECT id, val FROM t;
+CREATE VIEW v2 AS SELECT id, val FROM v1 WHERE id > 1;
+CREATE VIEW v3 AS SELECT v2.id, v1.val FROM v2 JOIN v1 ON v1.id = v2.id;
+CREATE VIEW v4 AS SELECT id FROM v3 UNION SELECT id FROM v2;
@@ -0,0 +1,29 @@
+DROP DATABASE IF EXISTS specific_43;
+CREATE DATABASE specific_43;
+
+USE specific_43;
+
+CREATE TABLE tenant_1 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_1 VALUES (1,'user1@tenant1.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant1.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant1.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant1.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant1.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant1.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant1.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant1.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant1.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant1.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant1.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant1.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant1.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant1.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant1.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant1.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant1.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant1.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant1.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant1.example.com','active','2024-01-21 10:00:00');
+CREATE TABLE tenant_2 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_2 VALUES (1,'user1@tenant2.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant2.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant2.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant2.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant2.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant2.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant2.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant2.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant2.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant2.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant2.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant2.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant2.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant2.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant2.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant2.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant2.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant2.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant2.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant2.example.com','active','2024-01-21 10:00:00');
+CREATE TABLE tenant_3 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_3 VALUES (1,'user1@tenant3.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant3.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant3.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant3.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant3.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant3.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant3.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant3.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant3.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant3.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant3.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant3.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant3.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant3.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant3.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant3.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant3.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant3.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant3.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant3.example.com','active','2024-01-21 10:00:00');
+CREATE TABLE tenant_4 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_4 VALUES (1,'user1@tenant4.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant4.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant4.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant4.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant4.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant4.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant4.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant4.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant4.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant4.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant4.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant4.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant4.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant4.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant4.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant4.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant4.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant4.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant4.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant4.example.com','active','2024-01-21 10:00:00');
+CREATE TABLE tenant_5 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_5 VALUES (1,'user1@tenant5.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant5.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant5.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant5.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant5.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant5.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant5.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant5.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant5.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant5.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant5.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant5.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant5.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant5.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant5.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant5.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant5.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant5.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant5.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant5.example.com','active','2024-01-21 10:00:00');
+CREATE TABLE tenant_6 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_6 VALUES (1,'user1@tenant6.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant6.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant6.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant6.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant6.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant6.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant6.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant6.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant6.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant6.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant6.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant6.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant6.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant6.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant6.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant6.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant6.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant6.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant6.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant6.example.com','active','2024-01-21 10:00:00');
+CREATE TABLE tenant_7 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_7 VALUES (1,'user1@tenant7.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant7.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant7.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant7.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant7.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant7.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant7.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant7.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant7.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant7.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant7.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant7.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant7.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant7.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant7.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant7.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant7.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant7.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant7.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant7.example.com','active','2024-01-21 10:00:00');
+CREATE TABLE tenant_8 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_8 VALUES (1,'user1@tenant8.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant8.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant8.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant8.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant8.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant8.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant8.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant8.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant8.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant8.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant8.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant8.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant8.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant8.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant8.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant8.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant8.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant8.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant8.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant8.example.com','active','2024-01-21 10:00:00');
+CREATE TABLE tenant_9 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_9 VALUES (1,'user1@tenant9.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant9.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant9.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant9.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant9.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant9.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant9.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant9.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant9.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant9.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant9.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant9.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant9.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant9.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant9.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant9.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant9.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant9.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant9.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant9.example.com','active','2024-01-21 10:00:00');
+CREATE TABLE tenant_10 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_10 VALUES (1,'user1@tenant10.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant10.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant10.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant10.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant10.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant10.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant10.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant10.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant10.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant10.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant10.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant10.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant10.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant10.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant10.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant10.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant10.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant10.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant10.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant10.example.com','active','2024-01-21 10:00:00');
+CREATE TABLE tenant_11 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_11 VALUES (1,'user1@tenant11.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant11.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant11.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant11.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant11.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant11.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant11.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant11.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant11.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant11.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant11.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant11.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant11.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant11.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant11.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant11.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant11.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant11.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant11.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant11.example.com','active','2024-01-21 10:00:00');
+CREATE TABLE tenant_12 (id int primary key, email varchar(64), status enum('active','disabled'), created datetime);
+INSERT INTO tenant_12 VALUES (1,'user1@tenant12.example.com','active','2024-01-02 10:00:00'),(2,'user2@tenant12.example.com','active','2024-01-03 10:00:00'),(3,'user3@tenant12.example.com','disabled','2024-01-04 10:00:00'),(4,'user4@tenant12.example.com','active','2024-01-05 10:00:00'),(5,'user5@tenant12.example.com','active','2024-01-06 10:00:00'),(6,'user6@tenant12.example.com','disabled','2024-01-07 10:00:00'),(7,'user7@tenant12.example.com','active','2024-01-08 10:00:00'),(8,'user8@tenant12.example.com','active','2024-01-09 10:00:00'),(9,'user9@tenant12.example.com','disabled','2024-01-10 10:00:00'),(10,'user10@tenant12.example.com','active','2024-01-11 10:00:00'),(11,'user11@tenant12.example.com','active','2024-01-12 10:00:00'),(12,'user12@tenant12.example.com','disabled','2024-01-13 10:00:00'),(13,'user13@tenant12.example.com','active','2024-01-14 10:00:00'),(14,'user14@tenant12.example.com','active','2024-01-15 10:00:00'),(15,'user15@tenant12.example.com','disabled','2024-01-16 10:00:00'),(16,'user16@tenant12.example.com','active','2024-01-17 10:00:00'),(17,'user17@tenant12.example.com','active','2024-01-18 10:00:00'),(18,'user18@tenant12.example.com','disabled','2024-01-19 10:00:00'),(19,'user19@tenant12.example.com','active','2024-01-20 10:00:00'),(20,'user20@tenant12.example.com','active','2024-01-21 10:00:00');
@@ -0,0 +1,26 @@
+DROP DATABASE IF EXISTS specific_44;
+CREATE DATABASE specific_44;
+
+USE specific_44;
+
+CREATE TABLE tenant_1 (id int primary key, name varchar(32), balance decimal(10,2), note text);
+INSERT INTO tenant_1 VALUES (1,'tenant1-user1',1.01,'note 1; with semicolon'),(2,'tenant1-user2',2.02,'note 2; with semicolon'),(3,'tenant1-user3',3.03,NULL),(4,'tenant1-user4',4.04,'note 4; with semicolon'),(5,'tenant1-user5',5.05,'note 5; with semicolon'),(6,'tenant1-user6',6.06,NULL),(7,'tenant1-user7',7.07,'note 7; with semicolon'),(8,'tenant1-user8',8.08,'note 8; with semicolon'),(9,'tenant1-user9',9.09,NULL),(10,'tenant1-user10',10.10,'note 10; with semicolon'),(11,'tenant1-user11',11.11,'note 11; with semicolon'),(12,'tenant1-user12',12.12,NULL),(13,'tenant1-user13',13.13,'note 13; with semicolon'),(14,'tenant1-user14',14.14,'note 14; with semicolon'),(15,'tenant1-user15',15.15,NULL);
+CREATE TABLE tenant_2 (id int primary key, name varchar(32), balance decimal(10,2), note text);
+INSERT INTO tenant_2 VALUES (1,'tenant2-user1',2.01,'note 1; with semicolon'),(2,'tenant2-user2',4.02,'note 2; with semicolon'),(3,'tenant2-user3',6.03,NULL),(4,'tenant2-user4',8.04,'note 4; with semicolon'),(5,'tenant2-user5',10.05,'note 5; with semicolon'),(6,'tenant2-user6',12.06,NULL),(7,'tenant2-user7',14.07,'note 7; with semicolon'),(8,'tenant2-user8',16.08,'note 8; with semicolon'),(9,'tenant2-user9',18.09,NULL),(10,'tenant2-user10',20.10,'note 10; with semicolon'),(11,'tenant2-user11',22.11,'note 11; with semicolon'),(12,'tenant2-user12',24.12,NULL),(13,'tenant2-user13',26.13,'note 13; with semicolon'),(14,'tenant2-user14',28.14,'note 14; with semicolon'),(15,'tenant2-user15',30.15,NULL);
+CREATE TABLE tenant_3 (id int primary key, name varchar(32), balance decimal(10,2), note text);
+INSERT INTO tenant_3 VALUES (1,'tenant3-user1',3.01,'note 1; with semicolon'),(2,'tenant3-user2',6.02,'note 2; with semicolon'),(3,'tenant3-user3',9.03,NULL),(4,'tenant3-user4',12.04,'note 4; with semicolon'),(5,'tenant3-user5',15.05,'note 5; with semicolon'),(6,'tenant3-user6',18.06,NULL),(7,'tenant3-user7',21.07,'note 7; with semicolon'),(8,'tenant3-user8',24.08,'note 8; with semicolon'),(9,'tenant3-user9',27.09,NULL),(10,'tenant3-user10',30.10,'note 10; with semicolon'),(11,'tenant3-user11',33.11,'note 11; with semicolon'),(12,'tenant3-user12',36.12,NULL),(13,'tenant3-user13',39.13,'note 13; with semicolon'),(14,'tenant3-user14',42.14,'note 14; with semicolon'),(15,'tenant3-user15',45.15,NULL);
+CREATE TABLE tenant_4 (id int primary key, name varchar(32), balance decimal(10,2), note text);
+INSERT INTO tenant_4 VALUES (1,'tenant4-user1',4.01,'note 1; with semicolon'),(2,'tenant4-user2',8.02,'note 2; with semicolon'),(3,'tenant4-user3',12.03,NULL),(4,'tenant4-user4',16.04,'note 4; with semicolon'),(5,'tenant4-user5',20.05,'note 5; with semicolon'),(6,'tenant4-user6',24.06,NULL),(7,'tenant4-user7',28.07,'note 7; with semicolon'),(8,'tenant4-user8',32.08,'note 8; with semicolon'),(9,'tenant4-user9',36.09,NULL),(10,'tenant4-user10',40.10,'note 10; with semicolon'),(11,'tenant4-user11',44.11,'note 11; with semicolon'),(12,'tenant4-user12',48.12,NULL),(13,'tenant4-user13',52.13,'note 13; with semicolon'),(14,'tenant4-user14',56.14,'note 14; with semicolon'),(15,'tenant4-user15',60.15,NULL);
+CREATE TABLE tenant_5 (id int primary key, name varchar(32), balance decimal(10,2), note text);
+INSERT INTO tenant_5 VALUES (1,'tenant5-user1',5.01,'note 1; with semicolon'),(2,'tenant5-user2',10.02,'note 2; with semicolon'),(3,'tenant5-user3',15.03,NULL),(4,'tenant5-user4',20.04,'note 4; with semicolon'),(5,'tenant5-user5',25.05,'note 5; with semicolon'),(6,'tenant5-user6',30.06,NULL),(7,'tenant5-user7',35.07,'note 7; with semicolon'),(8,'tenant5-user8',40.08,'note 8; with semicolon'),(9,'tenant5-user9',45.09,NULL),(10,'tenant5-user10',50.10,'note 10; with semicolon'),(11,'tenant5-user11',55.11,'note 11; with semicolon'),(12,'tenant5-user12',60.12,NULL),(13,'tenant5-user13',65.13,'note 13; with semicolon'),(14,'tenant5-user14',70.14,'note 14; with semicolon'),(15,'tenant5-user15',75.15,NULL);
+CREATE TABLE tenant_6 (id int primary key, name varchar(32), balance decimal(10,2), note text);
+INSERT INTO tenant_6 VALUES (1,'tenant6-user1',6.01,'note 1; with semicolon'),(2,'tenant6-user2',12.02,'note 2; with semicolon'),(3,'tenant6-user3',18.03,NULL),(4,'tenant6-user4',24.04,'note 4; with semicolon'),(5,'tenant6-user5',30.05,'note 5; with semicolon'),(6,'tenant6-user6',36.06,NULL),(7,'tenant6-user7',42.07,'note 7; with semicolon'),(8,'tenant6-user8',48.08,'note 8; with semicolon'),(9,'tenant6-user9',54.09,NULL),(10,'tenant6-user10',60.10,'note 10; with semicolon'),(11,'tenant6-user11',66.11,'note 11; with semicolon'),(12,'tenant6-user12',72.12,NULL),(13,'tenant6-user13',78.13,'note 13; with semicolon'),(14,'tenant6-user14',84.14,'note 14; with semicolon'),(15,'tenant6-user15',90.15,NULL);
+CREATE TABLE tenant_7 (id int primary key, name varchar(32), balance decimal(10,2), note text);
+INSERT INTO tenant_7 VALUES (1,'tenant7-user1',7.01,'note 1; with semicolon'),(2,'tenant7-user2',14.02,'note 2; with semicolon'),(3,'tenant7-user3',21.03,NULL),(4,'tenant7-user4',28.04,'note 4; with semicolon'),(5,'tenant7-user5',35.05,'note 5; with semicolon'),(6,'tenant7-user6',42.06,NULL),(7,'tenant7-user7',49.07,'note 7; with semicolon'),(8,'tenant7-user8',56.08,'note 8; with semicolon'),(9,'tenant7-user9',63.09,NULL),(10,'tenant7-user10',70.10,'note 10; with semicolon'),(11,'tenant7-user11',77.11,'note 11; with semicolon'),(12,'tenant7-user12',84.12,NULL),(13,'tenant7-user13',91.13,'note 13; with semicolon'),(14,'tenant7-user14',98.14,'note 14; with semicolon'),(15,'tenant7-user15',105.15,NULL);
+CREATE TABLE tenant_8 (id int primary key, name varchar(32), balance decimal(10,2), note text);
+INSERT INTO tenant_8 VALUES (1,'tenant8-user1',8.01,'note 1; with semicolon'),(2,'tenant8-user2',16.02,'note 2; with semicolon'),(3,'tenant8-user3',24.03,NULL),(4,'tenant8-user4',32.04,'note 4; with semicolon'),(5,'tenant8-user5',40.05,'note 5; with semicolon'),(6,'tenant8-user6',48.06,NULL),(7,'tenant8-user7',56.07,'note 7; with semicolon'),(8,'tenant8-user8',64.08,'note 8; with semicolon'),(9,'tenant8-user9',72.09,NULL),(10,'tenant8-user10',80.10,'note 10; with semicolon'),(11,'tenant8-user11',88.11,'note 11; with semicolon'),(12,'tenant8-user12',96.12,NULL),(13,'tenant8-user13',104.13,'note 13; with semicolon'),(14,'tenant8-user14',112.14,'note 14; with semicolon'),(15,'tenant8-user15',120.15,NULL);
+CREATE TABLE tenant_9 (id int primary key, name varchar(32), balance decimal(10,2), note text);
+INSERT INTO tenant_9 VALUES (1,'tenant9-user1',9.01,'note 1; with semicolon'),(2,'tenant9-user2',18.02,'note 2; with semicolon'),(3,'tenant9-user3',27.03,NULL),(4,'tenant9-user4',36.04,'note 4; with semicolon'),(5,'tenant9-user5',45.05,'note 5; with semicolon'),(6,'tenant9-user6',54.06,NULL),(7,'tenant9-user7',63.07,'note 7; with semicolon'),(8,'tenant9-user8',72.08,'note 8; with semicolon'),(9,'tenant9-user9',81.09,NULL),(10,'tenant9-user10',90.10,'note 10; with semicolon'),(11,'tenant9-user11',99.11,'note 11; with semicolon'),(12,'tenant9-user12',108.12,NULL),(13,'tenant9-user13',117.13,'note 13; with semicolon'),(14,'tenant9-user14',126.14,'note 14; with semicolon'),(15,'tenant9-user15',135.15,NULL);
+CREATE TABLE tenant_10 (id int primary key, name varchar(32), balance decimal(10,2), note text);
+INSERT INTO tenant_10 VALUES (1,'tenant10-user1',10.01,'note 1; with semicolon'),(2,'tenant10-user2',20.02,'note 2; with semicolon'),(3,'tenant10-user3',30.03,NULL),(4,'tenant10-user4',40.04,'note 4; with semicolon'),(5,'tenant10-user5',50.05,'note 5; with semicolon'),(6,'tenant10-user6',60.06,NULL),(7,'tenant10-user7',70.07,'note 7; with semicolon'),(8,'tenant10-user8',80.08,'note 8; with semicolon'),(9,'tenant10-user9',90.09,NULL),(10,'tenant10-user10',100.10,'note 10; with semicolon'),(11,'tenant10-user11',110.11,'note 11; with semicolon'),(12,'tenant10-user12',120.12,NULL),(13,'tenant10-user13',130.13,'note 13; with semicolon'),(14,'tenant10-user14',140.14,'note 14; with semicolon'),(15,'tenant10-user15',150.15,NULL);
+CREATE TABLE empty_tenant (id int primary key, name varchar(32));
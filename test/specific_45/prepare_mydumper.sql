@@ -0,0 +1,21 @@
+DROP DATABASE IF EXISTS specific_45;
+CREATE DATABASE specific_45;
+
+USE specific_45;
+
+CREATE TABLE events (tenant int, kind varchar(16), payload varchar(255));
+INSERT INTO events VALUES (1,'login',REPEAT('session;token=abc123 ',10)),(2,'logout',NULL),(3,'purchase',REPEAT('item=42;qty=1 ',12));
+INSERT INTO events SELECT tenant+3, kind, payload FROM events;
+INSERT INTO events SELECT tenant+6, kind, payload FROM events;
+INSERT INTO events SELECT tenant+12, kind, payload FROM events;
+INSERT INTO events SELECT tenant+24, kind, payload FROM events;
+INSERT INTO events SELECT tenant+48, kind, payload FROM events;
+INSERT INTO events SELECT tenant+96, kind, payload FROM events;
+INSERT INTO events SELECT tenant+192, kind, payload FROM events;
+INSERT INTO events SELECT tenant+384, kind, payload FROM events;
+INSERT INTO events SELECT tenant+768, kind, payload FROM events;
+INSERT INTO events SELECT tenant+1536, kind, payload FROM events;
+INSERT INTO events SELECT tenant+3072, kind, payload FROM events;
+INSERT INTO events SELECT tenant+6144, kind, payload FROM events;
+INSERT INTO events SELECT tenant+12288, kind, payload FROM events;
+INSERT INTO events SELECT tenant+24576, kind, payload FROM events;
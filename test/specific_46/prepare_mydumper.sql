@@ -0,0 +1,23 @@
+DROP DATABASE IF EXISTS specific_46;
+CREATE DATABASE specific_46;
+
+USE specific_46;
+
+CREATE TABLE audit_log (id int primary key auto_increment, action varchar(32), detail varchar(255));
+INSERT INTO audit_log (action, detail) VALUES ('insert',REPEAT('row=1;', 30)),('update',NULL),('delete',REPEAT('key=abc ', 20)),('select','single');
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+INSERT INTO audit_log (action, detail) SELECT action, detail FROM audit_log;
+
+CREATE TABLE settings (name varchar(32) primary key, value varchar(64));
+INSERT INTO settings VALUES ('timezone','UTC'),('locale','en_US'),('quote','it''s');
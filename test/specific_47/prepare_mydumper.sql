@@ -0,0 +1,21 @@
+DROP DATABASE IF EXISTS specific_47;
+CREATE DATABASE specific_47;
+
+USE specific_47;
+
+CREATE TABLE customers (id int primary key auto_increment, name varchar(64), card char(16), notes text);
+INSERT INTO customers (name, card, notes) VALUES ('alice','4111111111111111',REPEAT('a', 300)),('bob',NULL,'single'),('carol','5500000000000004',NULL),('dave','',REPEAT('xyz ', 50));
+INSERT INTO customers (name, card, notes) SELECT name, card, notes FROM customers;
+INSERT INTO customers (name, card, notes) SELECT name, card, notes FROM customers;
+INSERT INTO customers (name, card, notes) SELECT name, card, notes FROM customers;
+INSERT INTO customers (name, card, notes) SELECT name, card, notes FROM customers;
+INSERT INTO customers (name, card, notes) SELECT name, card, notes FROM customers;
+INSERT INTO customers (name, card, notes) SELECT name, card, notes FROM customers;
+INSERT INTO customers (name, card, notes) SELECT name, card, notes FROM customers;
+INSERT INTO customers (name, card, notes) SELECT name, card, notes FROM customers;
+INSERT INTO customers (name, card, notes) SELECT name, card, notes FROM customers;
+INSERT INTO customers (name, card, notes) SELECT name, card, notes FROM customers;
+
+CREATE TABLE empty_table (id int primary key, v varchar(10));
+
+CREATE VIEW customers_view AS SELECT id, name FROM customers;
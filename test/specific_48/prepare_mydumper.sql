@@ -0,0 +1,24 @@
+DROP DATABASE IF EXISTS specific_48;
+CREATE DATABASE specific_48;
+
+USE specific_48;
+
+CREATE TABLE values_table (id int primary key auto_increment, name varchar(64), amount decimal(10,2), ratio double, created datetime, notes text, data varbinary(16));
+INSERT INTO values_table (name, amount, ratio, created, notes, data) VALUES ('it''s',-10.5,1.5e-3,'2024-01-02 03:04:05','line\nbreak',UNHEX('00FF10')),('NULL',NULL,NULL,NULL,NULL,NULL),('back\\slash',0,0,'2024-02-29 00:00:00','',''),('comma, (paren)\n',99999999.99,-1e300,'1970-01-01 00:00:01','tab\there','abc');
+INSERT INTO values_table (name, amount, ratio, created, notes, data) SELECT name, amount, ratio, created, notes, data FROM values_table;
+INSERT INTO values_table (name, amount, ratio, created, notes, data) SELECT name, amount, ratio, created, notes, data FROM values_table;
+INSERT INTO values_table (name, amount, ratio, created, notes, data) SELECT name, amount, ratio, created, notes, data FROM values_table;
+INSERT INTO values_table (name, amount, ratio, created, notes, data) SELECT name, amount, ratio, created, notes, data FROM values_table;
+INSERT INTO values_table (name, amount, ratio, created, notes, data) SELECT name, amount, ratio, created, notes, data FROM values_table;
+INSERT INTO values_table (name, amount, ratio, created, notes, data) SELECT name, amount, ratio, created, notes, data FROM values_table;
+INSERT INTO values_table (name, amount, ratio, created, notes, data) SELECT name, amount, ratio, created, notes, data FROM values_table;
+INSERT INTO values_table (name, amount, ratio, created, notes, data) SELECT name, amount, ratio, created, notes, data FROM values_table;
+INSERT INTO values_table (name, amount, ratio, created, notes, data) SELECT name, amount, ratio, created, notes, data FROM values_table;
+
+CREATE TABLE bits_table (id int primary key, flags bit(8), pos point);
+INSERT INTO bits_table VALUES (1, b'10101010', POINT(1,2)), (2, NULL, NULL);
+
+CREATE TABLE with_trigger (id int primary key, v varchar(10));
+CREATE TABLE trigger_log (id int primary key auto_increment, v varchar(10));
+CREATE TRIGGER with_trigger_ai AFTER INSERT ON with_trigger FOR EACH ROW INSERT INTO trigger_log (v) VALUES (NEW.v);
+INSERT INTO with_trigger VALUES (1,'a'),(2,'b');